@@ -114,6 +114,11 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
+    std::string MMapManager::GetTileFileName(uint32 mapId, int32 x, int32 y)
+    {
+        return Trinity::StringFormat(TILE_FILE_NAME_FORMAT, sConfigMgr->GetStringDefault("DataDir", ".").c_str(), mapId, x, y);
+    }
+
     bool MMapManager::loadMap(const std::string& /* basePath */, uint32 mapId, int32 x, int32 y)
     {
         // make sure the mmap is loaded and ready to load tiles
@@ -130,7 +135,7 @@ namespace MMAP
             return false;
 
         // load this tile :: mmaps/MMMXXYY.mmtile
-        std::string fileName = Trinity::StringFormat(TILE_FILE_NAME_FORMAT, sConfigMgr->GetStringDefault("DataDir", ".").c_str(), mapId, x, y);
+        std::string fileName = GetTileFileName(mapId, x, y);
         FILE* file = fopen(fileName.c_str(), "rb");
         if (!file)
         {
@@ -277,16 +282,18 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        std::lock_guard<std::mutex> lock(mmap->navMeshQueriesLock);
+        auto queries = mmap->navMeshQueries.find(instanceId);
+        if (queries == mmap->navMeshQueries.end())
         {
             TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
             return false;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        for (auto& threadQuery : queries->second)
+            dtFreeNavMeshQuery(threadQuery.second);
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
+        mmap->navMeshQueries.erase(queries);
         TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -307,24 +314,30 @@ namespace MMAP
         if (itr == loadedMMaps.end())
             return nullptr;
 
-        MMapData* mmap = itr->second;
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            ASSERT(query);
-            if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
-            {
-                dtFreeNavMeshQuery(query);
-                TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return nullptr;
-            }
+        return GetThreadNavMeshQuery(itr->second, instanceId);
+    }
 
-            TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(MMapData* mmap, uint32 id)
+    {
+        std::lock_guard<std::mutex> lock(mmap->navMeshQueriesLock);
+        ThreadNavMeshQuerySet& queries = mmap->navMeshQueries[id];
+        auto itr = queries.find(std::this_thread::get_id());
+        if (itr != queries.end())
+            return itr->second;
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for id %u", id);
+            return nullptr;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for id %u", id);
+        queries.insert(ThreadNavMeshQuerySet::value_type(std::this_thread::get_id(), query));
+        return query;
     }
 
     bool MMapManager::loadGameObject(uint32 displayId)
@@ -400,29 +413,6 @@ namespace MMAP
         if (loadedModels.find(displayId) == loadedModels.end())
             return nullptr;
 
-        MMapData* mmap = loadedModels[displayId];
-
-        dtNavMeshQuery* navMeshQuery = nullptr;
-
-        NavMeshQuerySet::iterator it = mmap->navMeshQueries.find(displayId);
-        if (it == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            navMeshQuery = dtAllocNavMeshQuery();
-            ASSERT(navMeshQuery);
-            if (dtStatusFailed(navMeshQuery->init(mmap->navMesh, 1024)))
-            {
-                dtFreeNavMeshQuery(navMeshQuery);
-                TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u displayId %u", displayId, displayId);
-                return nullptr;
-            }
-
-            TC_LOG_TRACE("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for displayid %03u displayId %u", displayId, displayId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(displayId, navMeshQuery));
-        }
-        else
-            navMeshQuery = it->second;
-
-        return navMeshQuery;
+        return GetThreadNavMeshQuery(loadedModels[displayId], displayId);
     }
 }
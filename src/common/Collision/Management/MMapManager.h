@@ -23,7 +23,9 @@
 #include "DetourAlloc.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -31,7 +33,8 @@
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> ThreadNavMeshQuerySet;
+    typedef std::unordered_map<uint32, ThreadNavMeshQuerySet> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
@@ -40,7 +43,8 @@ namespace MMAP
         ~MMapData()
         {
             for (auto & navMeshQuerie : navMeshQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
+                for (auto & threadQuery : navMeshQuerie.second)
+                    dtFreeNavMeshQuery(threadQuery.second);
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
@@ -48,8 +52,10 @@ namespace MMAP
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // we have to use single dtNavMeshQuery for every instance and thread, since those are not thread safe
+        // (regions of a map are updated by several threads at once)
+        NavMeshQuerySet navMeshQueries;     // instanceId to thread to query
+        std::mutex navMeshQueriesLock;
         MMapTileSet loadedTileRefs;         // maps [map grid coords] to [dtTile]
     };
 
@@ -71,16 +77,20 @@ namespace MMAP
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // the returned [dtNavMeshQuery const*] is NOT threadsafe, it belongs to the calling thread and must only be used by it
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // full path of the file containing given tile
+            static std::string GetTileFileName(uint32 mapId, int32 x, int32 y);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            static dtNavMeshQuery const* GetThreadNavMeshQuery(MMapData* mmap, uint32 id);
 
             MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
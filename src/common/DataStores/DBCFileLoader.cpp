@@ -22,68 +22,47 @@
 
 #include "DBCFileLoader.h"
 #include "Errors.h"
+#include "MappedFile.h"
 
 DBCFileLoader::DBCFileLoader() : recordSize(0), recordCount(0), fieldCount(0), stringSize(0), fieldsOffset(nullptr), data(nullptr), stringTable(nullptr) { }
 
 bool DBCFileLoader::Load(char const* filename, char const* fmt)
 {
-    uint32 header;
-    if (data)
-    {
-        delete [] data;
-        data = nullptr;
-    }
+    mappedFile.reset();
+    data = nullptr;
+    stringTable = nullptr;
+    delete[] fieldsOffset;
+    fieldsOffset = nullptr;
 
-    FILE* f = fopen(filename, "rb");
-    if (!f)
+    std::shared_ptr<MappedFile> file = MappedFile::Open(filename);
+    if (!file)
         return false;
 
-    if (fread(&header, 4, 1, f) != 1)                        // Number of records
-    {
-        fclose(f);
+    // 'WDBC', number of records, number of fields, size of a record, string size
+    uint32 const* header = file->GetArray<uint32>(0, 5);
+    if (!header)
         return false;
-    }
 
-
-    EndianConvert(header);
-
-    if (header != 0x43424457)                                //'WDBC'
-    {
-        fclose(f);
+    uint32 magic = header[0];
+    EndianConvert(magic);
+    if (magic != 0x43424457)                                 //'WDBC'
         return false;
-    }
-
-    if (fread(&recordCount, 4, 1, f) != 1)                   // Number of records
-    {
-        fclose(f);
-        return false;
-    }
 
+    recordCount = header[1];
     EndianConvert(recordCount);
-
-    if (fread(&fieldCount, 4, 1, f) != 1)                    // Number of fields
-    {
-        fclose(f);
-        return false;
-    }
-
+    fieldCount = header[2];
     EndianConvert(fieldCount);
-
-    if (fread(&recordSize, 4, 1, f) != 1)                    // Size of a record
-    {
-        fclose(f);
-        return false;
-    }
-
+    recordSize = header[3];
     EndianConvert(recordSize);
+    stringSize = header[4];
+    EndianConvert(stringSize);
 
-    if (fread(&stringSize, 4, 1, f) != 1)                    // String size
-    {
-        fclose(f);
+    data = file->GetArray<unsigned char>(5 * sizeof(uint32), size_t(recordSize) * recordCount + stringSize);
+    if (!data)
         return false;
-    }
 
-    EndianConvert(stringSize);
+    stringTable = data + recordSize * recordCount;
+    mappedFile = std::move(file);
 
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
@@ -96,24 +75,11 @@ bool DBCFileLoader::Load(char const* filename, char const* fmt)
             fieldsOffset[i] += sizeof(uint32);
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
-    stringTable = data + recordSize*recordCount;
-
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
-    {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
-
     return true;
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
-
     delete[] fieldsOffset;
 }
 
@@ -260,13 +226,10 @@ char* DBCFileLoader::AutoProduceData(char const* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
+bool DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
 {
     if (strlen(format) != fieldCount)
-        return nullptr;
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+        return false;
 
     uint32 offset = 0;
 
@@ -291,10 +254,7 @@ char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
                     // fill only not filled entries
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !**slot)
-                    {
-                        const char * st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (char const*)stringTable);
-                    }
+                        *slot = const_cast<char*>(getRecord(y).getString(x)); // strings are never written to, they can stay in the read only mapping
                     offset += sizeof(char*);
                     break;
                  }
@@ -312,5 +272,5 @@ char* DBCFileLoader::AutoProduceStrings(char const* format, char* dataTable)
         }
     }
 
-    return stringPool;
+    return true;
 }
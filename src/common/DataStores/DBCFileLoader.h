@@ -22,6 +22,9 @@
 #include "Define.h"
 #include "Utilities/ByteConverter.h"
 #include <cassert>
+#include <memory>
+
+class MappedFile;
 
 enum DbcFieldFormat
 {
@@ -38,6 +41,10 @@ enum DbcFieldFormat
     FT_SQL_ABSENT='a'                                       //Used in sql format to mark column absent in sql dbc
 };
 
+/**
+    Reads .dbc files through a read only memory mapping (see MappedFile), records are converted to the core structures by AutoProduceData.
+    Strings are not copied, AutoProduceStrings points them directly into the mapping. Users of these strings must keep the mapping alive (see GetFile).
+*/
 class TC_COMMON_API DBCFileLoader
 {
     public:
@@ -52,21 +59,21 @@ class TC_COMMON_API DBCFileLoader
                 float getFloat(size_t field) const
                 {
                     assert(field < file.fieldCount);
-                    float val = *reinterpret_cast<float*>(offset+file.GetOffset(field));
+                    float val = *reinterpret_cast<float const*>(offset+file.GetOffset(field));
                     EndianConvert(val);
                     return val;
                 }
                 uint32 getUInt(size_t field) const
                 {
                     assert(field < file.fieldCount);
-                    uint32 val = *reinterpret_cast<uint32*>(offset+file.GetOffset(field));
+                    uint32 val = *reinterpret_cast<uint32 const*>(offset+file.GetOffset(field));
                     EndianConvert(val);
                     return val;
                 }
                 uint8 getUInt8(size_t field) const
                 {
                     assert(field < file.fieldCount);
-                    return *reinterpret_cast<uint8*>(offset+file.GetOffset(field));
+                    return *reinterpret_cast<uint8 const*>(offset+file.GetOffset(field));
                 }
 
                 const char *getString(size_t field) const
@@ -74,12 +81,12 @@ class TC_COMMON_API DBCFileLoader
                     assert(field < file.fieldCount);
                     size_t stringOffset = getUInt(field);
                     assert(stringOffset < file.stringSize);
-                    return reinterpret_cast<char*>(file.stringTable + stringOffset);
+                    return reinterpret_cast<char const*>(file.stringTable + stringOffset);
                 }
 
             private:
-                Record(DBCFileLoader &file_, unsigned char *offset_): offset(offset_), file(file_) { }
-                unsigned char *offset;
+                Record(DBCFileLoader &file_, unsigned char const* offset_): offset(offset_), file(file_) { }
+                unsigned char const* offset;
                 DBCFileLoader &file;
 
                 friend class DBCFileLoader;
@@ -95,8 +102,9 @@ class TC_COMMON_API DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
+        std::shared_ptr<MappedFile> const& GetFile() const { return mappedFile; }
         char* AutoProduceData(char const* fmt, uint32& count, char**& indexTable);
-        char* AutoProduceStrings(char const* fmt, char* dataTable);
+        bool AutoProduceStrings(char const* fmt, char* dataTable);
         static uint32 GetFormatRecordSize(const char * format, int32 * index_pos = nullptr);
     private:
 
@@ -105,8 +113,9 @@ class TC_COMMON_API DBCFileLoader
         uint32 fieldCount;
         uint32 stringSize;
         uint32 *fieldsOffset;
-        unsigned char *data;
-        unsigned char *stringTable;
+        std::shared_ptr<MappedFile> mappedFile;
+        unsigned char const* data;
+        unsigned char const* stringTable;
 
         DBCFileLoader(DBCFileLoader const& right) = delete;
         DBCFileLoader& operator=(DBCFileLoader const& right) = delete;
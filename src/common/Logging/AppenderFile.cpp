@@ -85,10 +85,15 @@ void AppenderFile::_write(LogMessage const* message)
         return;
 
     fprintf(logfile, "%s%s\n", message->prefix.c_str(), message->text.c_str());
-    fflush(logfile);
     _fileSize += uint64(message->Size());
 }
 
+void AppenderFile::flush()
+{
+    if (logfile)
+        fflush(logfile);
+}
+
 FILE* AppenderFile::OpenFile(std::string const& filename, std::string const& mode, bool backup)
 {
     std::string fullName(_logDir + filename);
@@ -104,6 +109,10 @@ FILE* AppenderFile::OpenFile(std::string const& filename, std::string const& mod
 
     if (FILE* ret = fopen(fullName.c_str(), mode.c_str()))
     {
+        // messages are written by batches with the async logging, see flush(). Files with a dynamic name are
+        // opened for a single message, keep the default buffer for these.
+        if (!_dynamicName)
+            setvbuf(ret, nullptr, _IOFBF, LOG_FILE_BUFFER_SIZE);
         _fileSize = ftell(ret);
         return ret;
     }
@@ -21,6 +21,8 @@
 #include "Appender.h"
 #include <atomic>
 
+#define LOG_FILE_BUFFER_SIZE (64 * 1024)
+
 class TC_COMMON_API AppenderFile : public Appender
 {
     public:
@@ -30,6 +32,7 @@ class TC_COMMON_API AppenderFile : public Appender
         ~AppenderFile();
         FILE* OpenFile(std::string const& name, std::string const& mode, bool backup);
         AppenderType getType() const override { return TypeIndex::value; }
+        void flush() override;
 
     private:
         void CloseFile();
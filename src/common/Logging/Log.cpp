@@ -25,13 +25,127 @@
 #include "Logger.h"
 #include "LogMessage.h"
 #include "LogOperation.h"
-#include "Strand.h"
+#include "MPSCQueue.h"
 #include "Util.h"
 #include <chrono>
+#include <condition_variable>
 #include <sstream>
+#include <thread>
 
-Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL), _ioContext(nullptr), _strand(nullptr)
+#define LOG_WRITER_BATCH_SIZE 1024
+
+/* Messages are queued without locking by the threads logging them, then written by a single thread.
+Appenders are only flushed once per batch of messages, so that file appenders write them with a few big writes.
+When more than queueSize messages are waiting, new ones are either dropped (and their count logged) or wait for room. */
+struct Log::AsyncWriter
 {
+    AsyncWriter(Log* log, uint32 queueSize, bool blockWhenFull) : _log(log), _pending(0), _dropped(0), _stop(false),
+        _queueSize(queueSize), _blockWhenFull(blockWhenFull)
+    {
+        _thread = std::thread(&AsyncWriter::Run, this);
+    }
+
+    ~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _stop = true;
+        }
+        _wakeWriter.notify_one();
+        _wakeProducers.notify_all();
+        _thread.join();
+    }
+
+    void Queue(LogOperation* operation)
+    {
+        if (_queueSize && _pending.load(std::memory_order_relaxed) >= _queueSize)
+        {
+            if (!_blockWhenFull)
+            {
+                ++_dropped;
+                delete operation;
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(_lock);
+            _wakeProducers.wait(lock, [this] { return _pending.load() < _queueSize || _stop; });
+        }
+
+        // counted before being queued so that the writer never sees more messages than pending ones
+        bool const writerIdle = _pending++ == 0;
+        _queue.Enqueue(operation);
+
+        if (writerIdle)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _wakeWriter.notify_one();
+        }
+    }
+
+    void Run()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_lock);
+                _wakeWriter.wait(lock, [this] { return _pending.load() || _stop; });
+                if (_stop && !_pending)
+                    break;
+            }
+
+            uint32 written = 0;
+            LogOperation* operation;
+            while (written < LOG_WRITER_BATCH_SIZE && _queue.Dequeue(operation))
+            {
+                operation->call();
+                delete operation;
+                ++written;
+            }
+
+            // a message was counted but its producer is still queuing it
+            if (!written)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (uint32 dropped = _dropped.exchange(0))
+            {
+                LogMessage message(LOG_LEVEL_ERROR, "server", Trinity::StringFormat("Log queue is full (Log.Async.QueueSize), %u messages were dropped", dropped));
+                if (Logger const* logger = _log->GetLoggerByType(message.type))
+                    logger->write(&message);
+            }
+
+            _log->FlushAppenders();
+            _pending -= written;
+
+            if (_blockWhenFull)
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _wakeProducers.notify_all();
+            }
+        }
+    }
+
+    Log* _log;
+    MPSCQueue<LogOperation, &LogOperation::QueueLink> _queue;
+    std::atomic<uint32> _pending;
+    std::atomic<uint32> _dropped;
+    bool _stop;
+    uint32 _queueSize;
+    bool _blockWhenFull;
+
+    std::mutex _lock;
+    std::condition_variable _wakeWriter;
+    std::condition_variable _wakeProducers;
+    std::thread _thread;
+};
+
+Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL)
+{
+    for (std::atomic<uint8>& categoryLevel : _categoryLevels)
+        categoryLevel.store(LOG_CATEGORY_NO_LOG, std::memory_order_relaxed);
+
     m_logsTimestamp = "_" + GetTimestampStr();
     RegisterAppender<AppenderConsole>();
     RegisterAppender<AppenderFile>();
@@ -39,7 +153,7 @@ Log::Log() : AppenderId(0), lowestLogLevel(LOG_LEVEL_FATAL), _ioContext(nullptr)
 
 Log::~Log()
 {
-    delete _strand;
+    _asyncWriter.reset();
     Close();
 }
 
@@ -228,13 +342,19 @@ void Log::write(std::unique_ptr<LogMessage>&& msg) const
 {
     Logger const* logger = GetLoggerByType(msg->type);
 
-    if (_ioContext)
-    {
-        std::shared_ptr<LogOperation> logOperation = std::make_shared<LogOperation>(logger, std::move(msg));
-        Trinity::Asio::post(*_ioContext, Trinity::Asio::bind_executor(*_strand, [logOperation]() { logOperation->call(); }));
-    }
+    if (_asyncWriter)
+        _asyncWriter->Queue(new LogOperation(logger, std::move(msg)));
     else
+    {
         logger->write(msg.get());
+        logger->flush();
+    }
+}
+
+void Log::FlushAppenders()
+{
+    for (auto it = appenders.begin(); it != appenders.end(); ++it)
+        it->second->flush();
 }
 
 Logger const* Log::GetLoggerByType(std::string const& type) const
@@ -290,6 +410,8 @@ bool Log::SetLogLevel(std::string const& name, char const* newLevelc, bool isLog
 
         if (newLevel != LOG_LEVEL_DISABLED && newLevel < lowestLogLevel)
             lowestLogLevel = newLevel;
+
+        UpdateCategoryLevels();
     }
     else
     {
@@ -331,24 +453,50 @@ void Log::Close()
 {
     loggers.clear();
     appenders.clear();
+    UpdateCategoryLevels();
 }
 
-bool Log::ShouldLog(std::string const& type, LogLevel level) const
+bool Log::ShouldLog(std::string const& type, LogLevel level)
 {
-    // TODO: Use cache to store "Type.sub1.sub2": "Type" equivalence, should
-    // Speed up in cases where requesting "Type.sub1.sub2" but only configured
-    // Logger "Type"
+    return ShouldLog(GetCategoryId(type), level);
+}
 
-    // Don't even look for a logger if the LogLevel is lower than lowest log levels across all loggers
-    if (level < lowestLogLevel)
-        return false;
+uint32 Log::GetCategoryId(std::string const& type)
+{
+    std::lock_guard<std::mutex> lock(_categoriesLock);
+
+    auto itr = _categoryIds.find(type);
+    if (itr != _categoryIds.end())
+        return itr->second;
+
+    if (_categoryNames.size() >= LOG_CATEGORY_OVERFLOW)
+        return LOG_CATEGORY_OVERFLOW;
 
+    uint32 id = uint32(_categoryNames.size());
+    _categoryNames.push_back(type);
+    _categoryIds[type] = id;
+    _categoryLevels[id].store(GetCategoryLevel(type), std::memory_order_relaxed);
+    return id;
+}
+
+uint8 Log::GetCategoryLevel(std::string const& type) const
+{
     Logger const* logger = GetLoggerByType(type);
-    if (!logger)
-        return false;
+    if (!logger || logger->getLogLevel() == LOG_LEVEL_DISABLED)
+        return LOG_CATEGORY_NO_LOG;
 
-    LogLevel logLevel = logger->getLogLevel();
-    return logLevel != LOG_LEVEL_DISABLED && logLevel <= level;
+    return logger->getLogLevel();
+}
+
+void Log::UpdateCategoryLevels()
+{
+    std::lock_guard<std::mutex> lock(_categoriesLock);
+
+    for (uint32 id = 0; id < _categoryNames.size(); ++id)
+        _categoryLevels[id].store(GetCategoryLevel(_categoryNames[id]), std::memory_order_relaxed);
+
+    // Logger::write still filters messages of these categories by their actual logger
+    _categoryLevels[LOG_CATEGORY_OVERFLOW].store(uint8(loggers.empty() ? LOG_CATEGORY_NO_LOG : lowestLogLevel), std::memory_order_relaxed);
 }
 
 Log* Log::instance()
@@ -357,22 +505,18 @@ Log* Log::instance()
     return &instance;
 }
 
-void Log::Initialize(Trinity::Asio::IoContext* ioContext)
+void Log::Initialize(bool async)
 {
-    if (ioContext)
-    {
-        _ioContext = ioContext;
-        _strand = new Trinity::Asio::Strand(*ioContext);
-    }
-
     LoadFromConfig();
+
+    if (async)
+        _asyncWriter = Trinity::make_unique<AsyncWriter>(this, sConfigMgr->GetIntDefault("Log.Async.QueueSize", 100000),
+            sConfigMgr->GetIntDefault("Log.Async.Backpressure", 0) == 1);
 }
 
 void Log::SetSynchronous()
 {
-    delete _strand;
-    _strand = nullptr;
-    _ioContext = nullptr;
+    _asyncWriter.reset(); // writes remaining messages
 }
 
 void Log::LoadFromConfig()
@@ -388,4 +532,5 @@ void Log::LoadFromConfig()
 
     ReadAppendersFromConfig();
     ReadLoggersFromConfig();
+    UpdateCategoryLevels();
 }
@@ -20,11 +20,12 @@
 #define TRINITYCORE_LOG_H
 
 #include "Define.h"
-#include "AsioHacksFwd.h"
 #include "LogCommon.h"
 #include "StringFormat.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -32,16 +33,13 @@ class Appender;
 class Logger;
 struct LogMessage;
 
-namespace Trinity
-{
-    namespace Asio
-    {
-        class IoContext;
-    }
-}
-
 #define LOGGER_ROOT "root"
 
+#define MAX_LOG_CATEGORIES      2048
+#define LOG_CATEGORY_OVERFLOW   (MAX_LOG_CATEGORIES - 1) // shared by all categories past the limit, logs at the lowest level of all loggers
+#define LOG_CATEGORY_UNKNOWN    MAX_LOG_CATEGORIES
+#define LOG_CATEGORY_NO_LOG     (NUM_ENABLED_LOG_LEVELS + 1) // category level with no logger or a disabled logger
+
 typedef Appender*(*AppenderCreatorFn)(uint8 id, std::string const& name, LogLevel level, AppenderFlags flags, std::vector<char const*>&& extraArgs);
 
 template <class AppenderImpl>
@@ -65,11 +63,17 @@ class TC_COMMON_API Log
     public:
         static Log* instance();
 
-        void Initialize(Trinity::Asio::IoContext* ioContext);
+        // With async, messages are written by a dedicated thread (see Log.Async.* config)
+        void Initialize(bool async);
         void SetSynchronous();  // Not threadsafe - should only be called from main() after all threads are joined
         void LoadFromConfig();
         void Close();
-        bool ShouldLog(std::string const& type, LogLevel level) const;
+        bool ShouldLog(std::string const& type, LogLevel level);
+        // Use TC_LOG_CATEGORY to get categoryId
+        bool ShouldLog(uint32 categoryId, LogLevel level) const { return uint8(level) >= _categoryLevels[categoryId].load(std::memory_order_relaxed); }
+        /* Categories are filter types ("network.opcode"...) given an id on first use. Each id has the level of the logger the category
+        resolves to (itself or its closest parent) cached in a flat table, updated whenever loggers change. */
+        uint32 GetCategoryId(std::string const& type);
         bool SetLogLevel(std::string const& name, char const* level, bool isLogger = true);
 
         template<typename Format, typename... Args>
@@ -102,6 +106,8 @@ class TC_COMMON_API Log
         std::string const& GetLogsTimestamp() const { return m_logsTimestamp; }
 
     private:
+        struct AsyncWriter;
+
         static std::string GetTimestampStr();
         void write(std::unique_ptr<LogMessage>&& msg) const;
 
@@ -115,6 +121,9 @@ class TC_COMMON_API Log
         void RegisterAppender(uint8 index, AppenderCreatorFn appenderCreateFn);
         void outMessage(std::string const& filter, LogLevel level, std::string&& message);
         void outCommand(std::string&& message, std::string&& param1);
+        uint8 GetCategoryLevel(std::string const& type) const;
+        void UpdateCategoryLevels();
+        void FlushAppenders();
 
         std::unordered_map<uint8, AppenderCreatorFn> appenderFactory;
         std::unordered_map<uint8, std::unique_ptr<Appender>> appenders;
@@ -122,15 +131,48 @@ class TC_COMMON_API Log
         uint8 AppenderId;
         LogLevel lowestLogLevel;
 
+        std::mutex _categoriesLock;
+        std::unordered_map<std::string, uint32> _categoryIds;
+        std::vector<std::string> _categoryNames;
+        std::atomic<uint8> _categoryLevels[MAX_LOG_CATEGORIES];
+
         std::string m_logsDir;
         std::string m_logsTimestamp;
 
-        Trinity::Asio::IoContext* _ioContext;
-        Trinity::Asio::Strand* _strand;
+        std::unique_ptr<AsyncWriter> _asyncWriter;
 };
 
 #define sLog Log::instance()
 
+// Category id of a call site, string literals are only resolved on first use
+class LogCategoryCache
+{
+    public:
+        constexpr LogCategoryCache() : _id(LOG_CATEGORY_UNKNOWN) { }
+
+        template<size_t N>
+        uint32 Get(char const (&type)[N])
+        {
+            uint32 id = _id.load(std::memory_order_relaxed);
+            if (id == LOG_CATEGORY_UNKNOWN)
+            {
+                id = sLog->GetCategoryId(type);
+                _id.store(id, std::memory_order_relaxed);
+            }
+            return id;
+        }
+
+        // Filter types built at runtime can change between calls
+        template<typename T>
+        uint32 Get(T const& type) { return sLog->GetCategoryId(type); }
+
+    private:
+        std::atomic<uint32> _id;
+};
+
+#define TC_LOG_CATEGORY(filterType__) \
+    ([]() -> LogCategoryCache& { static LogCategoryCache cache; return cache; }().Get(filterType__))
+
 #define LOG_EXCEPTION_FREE(filterType__, level__, ...) \
     { \
         try \
@@ -151,7 +193,7 @@ void check_args(std::string const&, ...);
 // This will catch format errors on build time
 #define TC_LOG_MESSAGE_BODY(filterType__, level__, ...)                 \
         do {                                                            \
-            if (sLog->ShouldLog(filterType__, level__))                 \
+            if (sLog->ShouldLog(TC_LOG_CATEGORY(filterType__), level__)) \
             {                                                           \
                 if (false)                                              \
                     check_args(__VA_ARGS__);                            \
@@ -164,7 +206,7 @@ void check_args(std::string const&, ...);
         __pragma(warning(push))                                         \
         __pragma(warning(disable:4127))                                 \
         do {                                                            \
-            if (sLog->ShouldLog(filterType__, level__))                 \
+            if (sLog->ShouldLog(TC_LOG_CATEGORY(filterType__), level__)) \
                 LOG_EXCEPTION_FREE(filterType__, level__, __VA_ARGS__); \
         } while (0)                                                     \
         __pragma(warning(pop))
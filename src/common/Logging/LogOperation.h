@@ -19,6 +19,7 @@
 #define LOGOPERATION_H
 
 #include "Define.h"
+#include <atomic>
 #include <memory>
 
 class Logger;
@@ -33,6 +34,8 @@ class TC_COMMON_API LogOperation
 
         int call();
 
+        std::atomic<LogOperation*> QueueLink; // see Log::AsyncWriter
+
     protected:
         Logger const* logger;
         std::unique_ptr<LogMessage> msg;
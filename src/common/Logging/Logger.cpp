@@ -58,3 +58,10 @@ void Logger::write(LogMessage* message) const
         if (it->second)
             it->second->write(message);
 }
+
+void Logger::flush() const
+{
+    for (auto it = appenders.begin(); it != appenders.end(); ++it)
+        if (it->second)
+            it->second->flush();
+}
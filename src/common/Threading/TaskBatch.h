@@ -0,0 +1,77 @@
+#ifndef TRINITY_TASK_BATCH_H
+#define TRINITY_TASK_BATCH_H
+
+#include "ProducerConsumerQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* A set of tasks run in parallel by a pool of helper threads and the thread submitting them, see TaskBatch::Run.
+Helpers claim tasks by index until none are left. The batch owns its tasks and is shared with the helpers,
+since some of them may only pop it after all tasks are done and the submitting thread moved on. */
+class TaskBatch
+{
+    public:
+        typedef std::shared_ptr<TaskBatch> Ptr;
+
+        explicit TaskBatch(std::vector<std::function<void()>>&& tasks) :
+            m_tasks(std::move(tasks)),
+            m_next(0),
+            m_remaining(m_tasks.size())
+        {
+        }
+
+        // Push the batch once per helper needed to given queue, take part in the work and return once all tasks are done
+        static void Run(ProducerConsumerQueue<Ptr>& queue, size_t helperCount, std::vector<std::function<void()>>&& tasks)
+        {
+            if (tasks.empty())
+                return;
+
+            // no need to wake more helpers than there are tasks left after the one we're taking ourselves
+            size_t const helpers = std::min(helperCount, tasks.size() - 1);
+            Ptr batch = std::make_shared<TaskBatch>(std::move(tasks));
+            for (size_t i = 0; i < helpers; ++i)
+                queue.Push(batch);
+
+            batch->Work();
+            batch->Wait();
+        }
+
+        // Claim and run tasks until there is none left. Tasks are never touched again once all were claimed.
+        void Work()
+        {
+            for (size_t i = m_next++; i < m_tasks.size(); i = m_next++)
+            {
+                m_tasks[i]();
+
+                if (--m_remaining == 0)
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_finished.notify_all();
+                }
+            }
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while (m_remaining > 0)
+                m_finished.wait(lock);
+        }
+
+    private:
+        std::vector<std::function<void()>> const m_tasks;
+        std::atomic<size_t> m_next;
+        std::atomic<size_t> m_remaining;
+        std::mutex m_lock;
+        std::condition_variable m_finished;
+
+        TaskBatch(TaskBatch const& right) = delete;
+        TaskBatch& operator=(TaskBatch const& right) = delete;
+};
+
+#endif // TRINITY_TASK_BATCH_H
@@ -0,0 +1,42 @@
+
+#include "MappedFile.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// The region stays valid once the file mapping is destroyed, which closes the file. Only the region is kept, else every mapped file would hold a file descriptor.
+struct MappedFile::Impl
+{
+    boost::interprocess::mapped_region region;
+};
+
+std::shared_ptr<MappedFile> MappedFile::Open(std::string const& path, bool* exists /*= nullptr*/)
+{
+    boost::system::error_code error;
+    bool const isFile = boost::filesystem::is_regular_file(path, error);
+    if (exists)
+        *exists = isFile;
+
+    if (!isFile || boost::filesystem::file_size(path, error) == 0 || error)
+        return nullptr;
+
+    try
+    {
+        std::unique_ptr<Impl> impl = std::make_unique<Impl>();
+        boost::interprocess::file_mapping mapping(path.c_str(), boost::interprocess::read_only);
+        impl->region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+        return std::shared_ptr<MappedFile>(new MappedFile(std::move(impl)));
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        return nullptr;
+    }
+}
+
+MappedFile::MappedFile(std::unique_ptr<Impl> impl) : _impl(std::move(impl))
+{
+    _data = static_cast<uint8 const*>(_impl->region.get_address());
+    _size = _impl->region.get_size();
+}
+
+MappedFile::~MappedFile() = default;
@@ -0,0 +1,48 @@
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include "Define.h"
+#include <memory>
+#include <string>
+
+/**
+    Read only memory mapping of a whole file.
+    Pages are only read from disk when accessed, and are shared with every other mapping of the same file (including in other processes).
+    Data must not be written to.
+*/
+class TC_COMMON_API MappedFile
+{
+public:
+    /// Return nullptr if file does not exist, is empty or cannot be mapped. If given, exists tells the first case apart from the others.
+    static std::shared_ptr<MappedFile> Open(std::string const& path, bool* exists = nullptr);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    uint8 const* GetData() const { return _data; }
+    size_t GetSize() const { return _size; }
+
+    /// Return pointer to count T's at offset in file, or nullptr if out of file bounds
+    template<class T>
+    T const* GetArray(size_t offset, size_t count = 1) const
+    {
+        if (offset > _size || count * sizeof(T) > _size - offset)
+            return nullptr;
+
+        return reinterpret_cast<T const*>(_data + offset);
+    }
+
+private:
+    struct Impl;
+
+    MappedFile(std::unique_ptr<Impl> impl);
+
+    std::unique_ptr<Impl> _impl;
+    uint8 const* _data;
+    size_t _size;
+};
+
+#endif // _MAPPED_FILE_H_
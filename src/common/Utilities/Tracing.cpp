@@ -0,0 +1,174 @@
+#include "Tracing.h"
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    std::chrono::steady_clock::time_point const TracingStart = std::chrono::steady_clock::now();
+
+    thread_local std::shared_ptr<void> CurrentThreadBuffer;
+
+    void WriteJsonString(FILE* file, char const* str)
+    {
+        fputc('"', file);
+        for (; *str; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+                fputc('\\', file);
+            fputc(*str, file);
+        }
+        fputc('"', file);
+    }
+}
+
+Tracing* Tracing::instance()
+{
+    static Tracing instance;
+    return &instance;
+}
+
+uint64 Tracing::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - TracingStart).count();
+}
+
+Tracing::ThreadBuffer& Tracing::GetThreadBuffer()
+{
+    if (!CurrentThreadBuffer)
+    {
+        std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+        buffer->size = _bufferSize;
+        buffer->slots.reset(new TraceSlot[buffer->size]);
+        for (uint32 i = 0; i < buffer->size; ++i)
+            buffer->slots[i].sequence.store(0, std::memory_order_relaxed);
+        buffer->writeIndex = 0;
+
+        std::lock_guard<std::mutex> lock(_lock);
+        buffer->threadId = _buffers.size() + 1;
+        _buffers.push_back(buffer);
+        CurrentThreadBuffer = buffer;
+    }
+
+    return *static_cast<ThreadBuffer*>(CurrentThreadBuffer.get());
+}
+
+void Tracing::SetThreadName(std::string const& name)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(_lock);
+    buffer.threadName = name;
+}
+
+void Tracing::AddEvent(char const* category, char const* name, uint64 start, uint64 end, int64 arg)
+{
+    uint64 const duration = end - start;
+    if (duration < _minDuration.load(std::memory_order_relaxed))
+        return;
+
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64 const index = buffer.writeIndex.load(std::memory_order_relaxed);
+    TraceSlot& slot = buffer.slots[index % buffer.size];
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(uint32(std::min<uint64>(duration, std::numeric_limits<uint32>::max())), std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+bool Tracing::Dump(std::string const& filename, std::string& failureReason)
+{
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file)
+    {
+        failureReason = "Could not open file " + filename;
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        buffers = _buffers;
+    }
+
+    fputs("{\"traceEvents\":[\n", file);
+    bool first = true;
+    std::vector<TraceEvent> events;
+    for (std::shared_ptr<ThreadBuffer> const& buffer : buffers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->threadId);
+            WriteJsonString(file, buffer->threadName.empty() ? "unnamed" : buffer->threadName.c_str());
+            fputs("}}", file);
+            first = false;
+        }
+
+        // The owner thread keeps writing while we copy, skip the slots it started rewriting before we were done reading them
+        uint64 const size = buffer->size;
+        uint64 const end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64 const begin = end > size ? end - size : 0;
+        events.clear();
+        for (uint64 i = begin; i < end; ++i)
+        {
+            TraceSlot const& slot = buffer->slots[i % size];
+            uint64 const sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != i * 2 + 2)
+                continue;
+
+            TraceEvent event;
+            event.category = slot.category.load(std::memory_order_relaxed);
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+            event.arg = slot.arg.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            events.push_back(event);
+        }
+
+        for (TraceEvent const& event : events)
+        {
+            fputs(",\n{\"name\":", file);
+            WriteJsonString(file, event.name);
+            fputs(",\"cat\":", file);
+            WriteJsonString(file, event.category);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":%u", buffer->threadId, event.start, event.duration);
+            if (event.arg >= 0)
+                fprintf(file, ",\"args\":{\"id\":" SI64FMTD "}", event.arg);
+            fputc('}', file);
+        }
+    }
+    fputs("\n]}\n", file);
+
+    bool success = !ferror(file);
+    fclose(file);
+    if (!success)
+        failureReason = "Error while writing " + filename;
+
+    return success;
+}
+
+std::string Tracing::GetInfos() const
+{
+    std::stringstream infos;
+    infos << "Tracing is " << (IsEnabled() ? "enabled" : "disabled") << std::endl;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    for (std::shared_ptr<ThreadBuffer> const& buffer : _buffers)
+    {
+        uint64 const written = buffer->writeIndex.load(std::memory_order_relaxed);
+        infos << "- Thread " << buffer->threadId << " (" << (buffer->threadName.empty() ? "unnamed" : buffer->threadName) << "): "
+            << std::min<uint64>(written, buffer->size) << "/" << buffer->size << " events" << std::endl;
+    }
+
+    return infos.str();
+}
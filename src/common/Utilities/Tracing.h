@@ -0,0 +1,120 @@
+#ifndef _TRACING_H_
+#define _TRACING_H_
+
+#include "Define.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+    Scoped tracing, always compiled in and cheap enough to be left enabled in production (Tracing.Enable).
+    Each thread records the scopes it went through into its own ring buffer, only the last events are kept.
+    Buffers can be dumped at any time (.profiling trace dump) to a Chrome trace JSON file, to be opened with
+    chrome://tracing or https://ui.perfetto.dev to see after the fact why an update took that long.
+
+    Category and name must be string literals (only the pointers are stored).
+*/
+class TC_COMMON_API Tracing
+{
+public:
+    static Tracing* instance();
+
+    void SetEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /// Number of events kept per thread. Only applies to threads recording their first event after this call.
+    void SetBufferSize(uint32 size) { _bufferSize = std::max<uint32>(size, 1); }
+    /// Scopes shorter than this are not recorded, to keep the buffers for what matters
+    void SetMinDuration(uint32 microseconds) { _minDuration = microseconds; }
+
+    /// Name shown for the calling thread in the trace
+    void SetThreadName(std::string const& name);
+
+    bool Dump(std::string const& filename, std::string& failureReason);
+    std::string GetInfos() const;
+
+    /// Microseconds since tracing start
+    static uint64 Now();
+    void AddEvent(char const* category, char const* name, uint64 start, uint64 end, int64 arg);
+
+private:
+    Tracing() : _enabled(false), _bufferSize(65536), _minDuration(0) { }
+
+    struct TraceEvent
+    {
+        char const* category;
+        char const* name;
+        uint64 start;
+        uint32 duration;
+        int64 arg;
+    };
+
+    // Ring buffer slot, read by dumps while its thread may be rewriting it.
+    // sequence is 2 * index + 1 while event index is being written and 2 * index + 2 once done, readers skip slots it changed in.
+    struct TraceSlot
+    {
+        std::atomic<uint64> sequence;
+        std::atomic<char const*> category;
+        std::atomic<char const*> name;
+        std::atomic<uint64> start;
+        std::atomic<uint32> duration;
+        std::atomic<int64> arg;
+    };
+    // documented in Tracing.BufferSize description, worldserver.conf.dist
+    static_assert(sizeof(void*) != 8 || sizeof(TraceSlot) == 48, "Update Tracing.BufferSize event size in worldserver.conf.dist");
+
+    struct ThreadBuffer
+    {
+        uint32 threadId;
+        std::string threadName;
+        std::unique_ptr<TraceSlot[]> slots;
+        uint32 size;
+        std::atomic<uint64> writeIndex; // total number of events ever written, slots[writeIndex % size] is the next one
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+
+    std::atomic<bool> _enabled;
+    std::atomic<uint32> _bufferSize;
+    std::atomic<uint32> _minDuration;
+
+    mutable std::mutex _lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers; // buffers of exited threads are kept for the dumps
+};
+
+#define sTracing Tracing::instance()
+
+class TraceScope
+{
+public:
+    TraceScope(char const* category, char const* name, int64 arg = -1) : _category(category), _name(name), _arg(arg),
+        _active(sTracing->IsEnabled()), _start(_active ? Tracing::Now() : 0) { }
+
+    ~TraceScope()
+    {
+        if (_active)
+            sTracing->AddEvent(_category, _name, _start, Tracing::Now(), _arg);
+    }
+
+    TraceScope(TraceScope const&) = delete;
+    TraceScope& operator=(TraceScope const&) = delete;
+
+private:
+    char const* _category;
+    char const* _name;
+    int64 _arg;
+    bool _active;
+    uint64 _start;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+// Record the duration of the current scope
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+// Same, with an id shown in the event args (map id, account id...)
+#define TRACE_SCOPE_ARG(category, name, arg) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(category, name, int64(arg))
+
+#endif // _TRACING_H_
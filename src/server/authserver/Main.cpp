@@ -92,7 +92,7 @@ int main(int argc, char** argv)
     }
 
     sLog->RegisterAppender<AppenderDB>();
-    sLog->Initialize(nullptr);
+    sLog->Initialize(false);
 
    Trinity::Banner::Show("authserver",
         [](char const* text)
@@ -188,6 +188,27 @@ QueryResult DatabaseWorkerPool<T>::Query(char const* sql, T* connection /*= null
     return QueryResult(result);
 }
 
+template <class T>
+QueryResult DatabaseWorkerPool<T>::StreamQuery(char const* sql)
+{
+    T* connection = GetFreeConnection();
+    ResultSet* result = connection->StreamQuery(sql);
+    if (!result)
+    {
+        connection->Unlock();
+        return QueryResult(nullptr);
+    }
+
+    // from here the result unlocks the connection, once it has read all rows or is deleted
+    if (!result->NextRow())
+    {
+        delete result;
+        return QueryResult(nullptr);
+    }
+
+    return QueryResult(result);
+}
+
 template <class T>
 PreparedQueryResult DatabaseWorkerPool<T>::Query(PreparedStatement* stmt)
 {
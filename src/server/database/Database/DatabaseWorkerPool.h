@@ -139,6 +139,23 @@ class DatabaseWorkerPool
             return Query(Trinity::StringFormat(std::forward<Format>(sql), std::forward<Args>(args)...).c_str());
         }
 
+        //! Directly executes an SQL query in string format, its rows are then read from the server while the result is iterated
+        //! instead of all at once, for big tables loaded at startup. The result GetRowCount() is the number of rows read so far.
+        //! A connection stays in use until all rows were read or the result destroyed, which must happen in the calling thread.
+        //! Do not query this database from the same thread meanwhile, it may wait for that connection.
+        QueryResult StreamQuery(char const* sql);
+
+        //! Directly executes an SQL query in string format -with variable args-, its rows being read while the result is iterated.
+        //! See StreamQuery
+        template<typename Format, typename... Args>
+        QueryResult PStreamQuery(Format&& sql, Args&&... args)
+        {
+            if (Trinity::IsFormatEmptyOrNull(sql))
+                return QueryResult(nullptr);
+
+            return StreamQuery(Trinity::StringFormat(std::forward<Format>(sql), std::forward<Args>(args)...).c_str());
+        }
+
         //! Directly executes an SQL query in prepared format that will block the calling thread until finished.
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
         //! Statement must be prepared with CONNECTION_SYNCH flag.
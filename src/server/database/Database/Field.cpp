@@ -24,6 +24,10 @@ Field::Field()
     data.type = DatabaseFieldTypes::Null;
     data.length = 0;
     data.raw = false;
+#ifdef TRINITY_DEBUG
+    // no metadata for fields not read from MySQL (see ResultSet serialized rows)
+    meta = { "", "", "", "", "", 0 };
+#endif
 }
 
 Field::~Field()
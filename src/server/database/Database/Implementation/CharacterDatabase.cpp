@@ -265,9 +265,6 @@ void CharacterDatabaseConnection::DoPrepareStatements()
     PrepareStatement(CHAR_DEL_EQUIP_SET, "DELETE FROM character_equipmentsets WHERE setguid=?", CONNECTION_ASYNC);
     #endif
     */
-    // Auras
-    PrepareStatement(CHAR_INS_AURA, "INSERT INTO character_aura (guid, casterGuid, itemGuid, spell, effectMask, recalculateMask, stackCount, amount0, amount1, amount2, base_amount0, base_amount1, base_amount2, maxDuration, remainTime, remainCharges, critChance, applyResilience) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", CONNECTION_ASYNC);
 
     /*
     #ifdef LICH_KING
@@ -637,6 +634,13 @@ void CharacterDatabaseConnection::DoPrepareStatements()
     PrepareStatement(CHAR_DEL_ITEMCONTAINER_MONEY, "DELETE FROM item_loot_money WHERE container_id = ?", CONNECTION_ASYNC);
     PrepareStatement(CHAR_INS_ITEMCONTAINER_MONEY, "INSERT INTO item_loot_money (container_id, money) VALUES (?, ?)", CONNECTION_ASYNC);
 
+    // Random playerbots
+    PrepareStatement(CHAR_SEL_PLAYERBOT_RANDOM_BOTS_EVENTS, "SELECT bot, event, `value`, `time`, validIn FROM ai_playerbot_random_bots WHERE owner = 0", CONNECTION_SYNCH);
+    PrepareStatement(CHAR_DEL_PLAYERBOT_RANDOM_BOTS_EVENT, "DELETE FROM ai_playerbot_random_bots WHERE owner = 0 AND bot = ? AND event = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_INS_PLAYERBOT_RANDOM_BOTS_EVENT, "INSERT INTO ai_playerbot_random_bots (owner, bot, `time`, validIn, event, `value`) VALUES (0, ?, ?, ?, ?, ?)", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_DEL_PLAYERBOT_RANDOM_BOTS, "DELETE FROM ai_playerbot_random_bots", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_SEL_PLAYERBOT_CHAR_CACHE_INFO, "SELECT account, name, gender, race, class, level FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+
     /*
     // Calendar
     PrepareStatement(CHAR_REP_CALENDAR_EVENT, "REPLACE INTO calendar_events (id, creator, title, description, type, dungeon, eventtime, flags, time2) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)", CONNECTION_ASYNC);
@@ -222,7 +222,6 @@ enum CharacterDatabaseStatements : uint32
     CHAR_INS_EQUIP_SET,
     CHAR_DEL_EQUIP_SET,
     */
-    CHAR_INS_AURA,
     /*
     CHAR_SEL_ACCOUNT_DATA,
     CHAR_REP_ACCOUNT_DATA,
@@ -593,6 +592,12 @@ enum CharacterDatabaseStatements : uint32
     CHAR_DEL_ITEMCONTAINER_MONEY,
     CHAR_INS_ITEMCONTAINER_MONEY,
 
+    CHAR_SEL_PLAYERBOT_RANDOM_BOTS_EVENTS,
+    CHAR_DEL_PLAYERBOT_RANDOM_BOTS_EVENT,
+    CHAR_INS_PLAYERBOT_RANDOM_BOTS_EVENT,
+    CHAR_DEL_PLAYERBOT_RANDOM_BOTS,
+    CHAR_SEL_PLAYERBOT_CHAR_CACHE_INFO,
+
     MAX_CHARACTERDATABASE_STATEMENTS
 };
 
@@ -34,6 +34,11 @@
 #endif
 #include <mysql.h>
 #include <mysqld_error.h>
+#include <cctype>
+#include <cstring>
+
+// Raw transaction queries sent together are cut around this length, to stay well below the server max_allowed_packet
+#define MAX_MULTIPLE_STATEMENTS_LENGTH (1024 * 1024)
 
 MySQLConnectionInfo::MySQLConnectionInfo(std::string const& infoString)
 {
@@ -197,6 +202,45 @@ bool MySQLConnection::Execute(char const* sql)
     return true;
 }
 
+bool MySQLConnection::ExecuteMultiple(std::string const& sql, uint32& errNo)
+{
+    errNo = 0;
+    if (!m_Mysql)
+    {
+        errNo = CR_SERVER_GONE_ERROR;
+        return false;
+    }
+
+    ASSERT(m_connectionFlags & CONNECTION_ASYNC);
+
+    uint32 _s = GetMSTime();
+
+    // Statements run until the first error, and all their results must be read before sending anything else
+    int status = mysql_real_query(m_Mysql, sql.c_str(), sql.length());
+    while (!status)
+    {
+        if (MYSQL_RES* result = mysql_store_result(m_Mysql))
+            mysql_free_result(result);
+
+        status = mysql_next_result(m_Mysql);
+    }
+
+    if (status > 0)
+    {
+        errNo = mysql_errno(m_Mysql);
+
+        TC_LOG_INFO("sql.sql", "SQL: %s", sql.c_str());
+        TC_LOG_ERROR("sql.sql", "[%u] %s", errNo, mysql_error(m_Mysql));
+
+        // Not retried after a reconnection, part of the statements may have run already
+        _HandleMySQLErrno(errNo);
+        return false;
+    }
+
+    TC_LOG_DEBUG("sql.sql", "[%u ms] SQL: %s", GetMSTimeDiff(_s, GetMSTime()), sql.c_str());
+    return true;
+}
+
 bool MySQLConnection::Execute(PreparedStatement* stmt)
 {
     if (!m_Mysql)
@@ -315,7 +359,23 @@ ResultSet* MySQLConnection::Query(char const* sql)
     return new ResultSet(result, fields, rowCount, fieldCount);
 }
 
-bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount)
+ResultSet* MySQLConnection::StreamQuery(char const* sql)
+{
+    if (!sql)
+        return nullptr;
+
+    MYSQL_RES *result = nullptr;
+    MYSQL_FIELD *fields = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount, true))
+        return nullptr;
+
+    return new ResultSet(result, fields, 0, fieldCount, this);
+}
+
+bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount, bool stream /*= false*/)
 {
     if (!m_Mysql)
         return false;
@@ -330,22 +390,23 @@ bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD *
             TC_LOG_ERROR("sql.sql", "[%u] %s", lErrno, mysql_error(m_Mysql));
 
             if (_HandleMySQLErrno(lErrno))      // If it returns true, an error was handled successfully (i.e. reconnection)
-                return _Query(sql, pResult, pFields, pRowCount, pFieldCount);    // We try again
+                return _Query(sql, pResult, pFields, pRowCount, pFieldCount, stream);    // We try again
 
             return false;
         }
         else
             TC_LOG_DEBUG("sql.sql", "[%u ms] SQL: %s", GetMSTimeDiff(_s, GetMSTime()), sql);
 
-        *pResult = mysql_store_result(m_Mysql);
-        *pRowCount = mysql_affected_rows(m_Mysql);
+        // rows of an unbuffered result are only counted once all of them are read
+        *pResult = stream ? mysql_use_result(m_Mysql) : mysql_store_result(m_Mysql);
+        *pRowCount = stream ? 0 : mysql_affected_rows(m_Mysql);
         *pFieldCount = mysql_field_count(m_Mysql);
     }
 
     if (!*pResult )
         return false;
 
-    if (!*pRowCount)
+    if (!stream && !*pRowCount)
     {
         mysql_free_result(*pResult);
         return false;
@@ -377,7 +438,60 @@ int MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
     if (queries.empty())
         return -1;
 
-    BeginTransaction();
+    // On asynchronous connections, consecutive raw queries are sent in a single round trip, along with START TRANSACTION and COMMIT.
+    // If one of them fails the following ones are not executed, and the whole transaction is rolled back anyway.
+    // Multiple statements are only allowed by the server for the duration of the transaction, and only once a batch needs it.
+    bool const batchRawQueries = (m_connectionFlags & CONNECTION_ASYNC) != 0;
+    bool multiStatements = false;
+    std::string pendingRawQueries;
+    uint32 pendingRawCount = 0;
+    // error of the batch that failed, GetLastError() is reset if the connection was reopened meanwhile
+    uint32 batchErrno = 0;
+
+    auto setMultiStatements = [&](bool enable) -> bool
+    {
+        if (multiStatements == enable)
+            return true;
+
+        if (mysql_set_server_option(m_Mysql, enable ? MYSQL_OPTION_MULTI_STATEMENTS_ON : MYSQL_OPTION_MULTI_STATEMENTS_OFF))
+        {
+            batchErrno = mysql_errno(m_Mysql);
+            TC_LOG_ERROR("sql.sql", "Could not toggle multiple statements: [%u] %s", batchErrno, mysql_error(m_Mysql));
+            return false;
+        }
+
+        multiStatements = enable;
+        return true;
+    };
+
+    auto flushRawQueries = [&]() -> bool
+    {
+        if (!pendingRawCount)
+            return true;
+
+        // even a single statement does not go through Execute, which would run it again alone on a new connection after a disconnection
+        bool success = (pendingRawCount == 1 || setMultiStatements(true)) && ExecuteMultiple(pendingRawQueries, batchErrno);
+        pendingRawQueries.clear();
+        pendingRawCount = 0;
+        return success;
+    };
+
+    auto abort = [&]() -> int
+    {
+        TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
+        int errorCode = batchErrno ? batchErrno : GetLastError();
+        RollbackTransaction();
+        setMultiStatements(false);
+        return errorCode;
+    };
+
+    if (batchRawQueries)
+    {
+        pendingRawQueries = "START TRANSACTION";
+        pendingRawCount = 1;
+    }
+    else
+        BeginTransaction();
 
     for (auto itr = queries.begin(); itr != queries.end(); ++itr)
     {
@@ -388,26 +502,45 @@ int MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
             {
                 PreparedStatement* stmt = data.element.stmt;
                 ASSERT(stmt);
+                if (!flushRawQueries())
+                    return abort();
+
                 if (!Execute(stmt))
-                {
-                    TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    int errorCode = GetLastError();
-                    RollbackTransaction();
-                    return errorCode;
-                }
+                    return abort();
             }
             break;
             case SQL_ELEMENT_RAW:
             {
                 char const* sql = data.element.query;
                 ASSERT(sql);
-                if (!Execute(sql))
+                if (batchRawQueries)
                 {
-                    TC_LOG_WARN("sql.sql", "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    int errorCode = GetLastError();
-                    RollbackTransaction();
-                    return errorCode;
+                    // an empty statement between two ';' would be an error
+                    size_t length = strlen(sql);
+                    while (length && (sql[length - 1] == ';' || isspace(static_cast<unsigned char>(sql[length - 1]))))
+                        --length;
+
+                    if (!length)
+                        break;
+
+                    // a comment could hide the statements batched after this one, run it on its own
+                    if (strstr(sql, "--") || strchr(sql, '#') || strstr(sql, "/*"))
+                    {
+                        if (!flushRawQueries() || !ExecuteMultiple(std::string(sql, length), batchErrno))
+                            return abort();
+
+                        break;
+                    }
+
+                    if (pendingRawCount++)
+                        pendingRawQueries += ';';
+                    pendingRawQueries.append(sql, length);
+
+                    if (pendingRawQueries.length() >= MAX_MULTIPLE_STATEMENTS_LENGTH && !flushRawQueries())
+                        return abort();
                 }
+                else if (!Execute(sql))
+                    return abort();
             }
             break;
         }
@@ -418,7 +551,21 @@ int MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
     // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
     // and not while iterating over every element.
 
-    CommitTransaction();
+    if (batchRawQueries)
+    {
+        if (pendingRawCount++)
+            pendingRawQueries += ';';
+        pendingRawQueries += "COMMIT";
+
+        if (!flushRawQueries())
+            return abort();
+
+        // the transaction is committed, failing here means the connection was lost and the next one starts with the option off
+        setMultiStatements(false);
+    }
+    else
+        CommitTransaction();
+
     return 0;
 }
 
@@ -55,6 +55,7 @@ class TC_DATABASE_API MySQLConnection
 {
     template <class T> friend class DatabaseWorkerPool;
     friend class PingOperation;
+    friend class ResultSet; // streamed results release the connection once read
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
@@ -69,9 +70,14 @@ class TC_DATABASE_API MySQLConnection
     public:
         bool Execute(char const* sql);
         bool Execute(PreparedStatement* stmt);
+        // Several ';' separated statements in a single round trip, only on asynchronous connections with the multiple statements option on, see ExecuteTransaction
+        // On failure errNo is the error the statements failed with, the connection may have been reopened since
+        bool ExecuteMultiple(std::string const& sql, uint32& errNo);
         ResultSet* Query(char const* sql);
         PreparedResultSet* Query(PreparedStatement* stmt);
-        bool _Query(char const* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
+        // Rows are read from the server as the result is iterated, the connection stays locked until the result is done with it
+        ResultSet* StreamQuery(char const* sql);
+        bool _Query(char const* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount, bool stream = false);
         bool _Query(PreparedStatement* stmt, MYSQL_RES** pResult, uint64* pRowCount, uint32* pFieldCount);
 
         void BeginTransaction();
@@ -20,10 +20,13 @@
 #include "Errors.h"
 #include "Field.h"
 #include "Log.h"
+#include "MySQLConnection.h"
 #ifdef _WIN32 // hack for broken mysql.h not including the correct winsock header for SOCKET definition, fixed in 5.7
 #include <winsock2.h>
 #endif
 #include <mysql.h>
+#include <algorithm>
+#include <cstdlib>
 
 static uint32 SizeForType(MYSQL_FIELD* field)
 {
@@ -119,12 +122,22 @@ DatabaseFieldTypes MysqlTypeToFieldType(enum_field_types type)
     return DatabaseFieldTypes::Null;
 }
 
-ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount) :
+ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection /*= nullptr*/) :
 _rowCount(rowCount),
 _fieldCount(fieldCount),
 _result(result),
-_fields(fields)
+_fields(fields),
+_streamConnection(streamConnection),
+_streamed(streamConnection != nullptr),
+_rawValues(fieldCount, nullptr),
+_rawLengths(fieldCount, 0),
+_serializedPosition(nullptr),
+_serializedEnd(nullptr)
 {
+    _types.reserve(_fieldCount);
+    for (uint32 i = 0; i < _fieldCount; i++)
+        _types.push_back(MysqlTypeToFieldType(_fields[i].type));
+
     _currentRow = new Field[_fieldCount];
 #ifdef TRINITY_DEBUG
     for (uint32 i = 0; i < _fieldCount; i++)
@@ -132,6 +145,23 @@ _fields(fields)
 #endif
 }
 
+ResultSet::ResultSet(std::shared_ptr<void const> owner, uint8 const* rows, size_t size, uint64 rowCount, std::vector<DatabaseFieldTypes> types) :
+_rowCount(rowCount),
+_fieldCount(uint32(types.size())),
+_result(nullptr),
+_fields(nullptr),
+_streamConnection(nullptr),
+_streamed(false),
+_rawValues(types.size(), nullptr),
+_rawLengths(types.size(), 0),
+_serializedOwner(std::move(owner)),
+_serializedPosition(rows),
+_serializedEnd(rows + size),
+_types(std::move(types))
+{
+    _currentRow = new Field[_fieldCount];
+}
+
 PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64 rowCount, uint32 fieldCount) :
 m_rowCount(rowCount),
 m_rowPosition(0),
@@ -277,15 +307,37 @@ PreparedResultSet::~PreparedResultSet()
 
 bool ResultSet::NextRow()
 {
-    MYSQL_ROW row;
+    if (!NextRawRow())
+    {
+        CleanUp();
+        return false;
+    }
+
+    SetCurrentRow();
+    return true;
+}
+
+void ResultSet::SetCurrentRow()
+{
+    for (uint32 i = 0; i < _fieldCount; i++)
+        _currentRow[i].SetStructuredValue(const_cast<char*>(_rawValues[i]), _types[i], _rawLengths[i]);
+}
+
+bool ResultSet::NextRawRow()
+{
+    if (_serializedOwner)
+        return NextSerializedRow();
 
     if (!_result)
         return false;
 
-    row = mysql_fetch_row(_result);
+    MYSQL_ROW row = mysql_fetch_row(_result);
     if (!row)
     {
-        CleanUp();
+        // unbuffered results only get network errors here
+        if (_streamed && mysql_errno(_result->handle))
+            TC_LOG_ERROR("sql.sql", "%s:mysql_fetch_row, cannot read streamed row " UI64FMTD ". Error %s.", __FUNCTION__, _rowCount, mysql_error(_result->handle));
+
         return false;
     }
 
@@ -293,16 +345,104 @@ bool ResultSet::NextRow()
     if (!lengths)
     {
         TC_LOG_WARN("sql.sql", "%s:mysql_fetch_lengths, cannot retrieve value lengths. Error %s.", __FUNCTION__, mysql_error(_result->handle));
-        CleanUp();
         return false;
     }
 
     for (uint32 i = 0; i < _fieldCount; i++)
-        _currentRow[i].SetStructuredValue(row[i], MysqlTypeToFieldType(_fields[i].type), lengths[i]);
+    {
+        _rawValues[i] = row[i];
+        _rawLengths[i] = uint32(lengths[i]);
+    }
+
+    if (_streamed)
+        ++_rowCount;
+
+    return true;
+}
+
+bool ResultSet::FetchColumns(ResultColumns& columns, uint32 maxRows)
+{
+    columns.Reset(_types);
+    if (!_currentRow)
+        return false;
+
+    // current row values were read by the last NextRow, and are still valid
+    do
+    {
+        for (uint32 i = 0; i < _fieldCount; i++)
+            columns.AppendValue(i, _rawValues[i], _rawLengths[i]);
+
+        ++columns._rowCount;
+
+        if (!NextRawRow())
+        {
+            CleanUp();
+            return false;
+        }
+    } while (columns._rowCount < maxRows);
+
+    SetCurrentRow();
+    return true;
+}
+
+// Serialized fields are their length followed by their data, as returned by mysql_fetch_row. Null fields only have a NULL_FIELD_LENGTH length.
+static uint32 const NULL_FIELD_LENGTH = 0xFFFFFFFF;
+
+bool ResultSet::NextSerializedRow()
+{
+    if (_serializedPosition == _serializedEnd)
+        return false;
+
+    for (uint32 i = 0; i < _fieldCount; i++)
+    {
+        uint32 length;
+        if (size_t(_serializedEnd - _serializedPosition) < sizeof(length))
+            return false;
+
+        memcpy(&length, _serializedPosition, sizeof(length));
+        _serializedPosition += sizeof(length);
+
+        if (length == NULL_FIELD_LENGTH)
+        {
+            _rawValues[i] = nullptr;
+            _rawLengths[i] = 0;
+            continue;
+        }
+
+        if (size_t(_serializedEnd - _serializedPosition) < length)
+            return false;
+
+        _rawValues[i] = reinterpret_cast<char const*>(_serializedPosition);
+        _rawLengths[i] = length;
+        _serializedPosition += length;
+    }
 
     return true;
 }
 
+DatabaseFieldTypes ResultSet::GetFieldType(uint32 index) const
+{
+    ASSERT(index < _fieldCount);
+    return _types[index];
+}
+
+void ResultSet::AppendRow(std::vector<uint8>& buffer) const
+{
+    for (uint32 i = 0; i < _fieldCount; i++)
+    {
+        Field const& field = _currentRow[i];
+        uint32 const length = field.IsNull() ? NULL_FIELD_LENGTH : field.data.length;
+        uint8 const* lengthBytes = reinterpret_cast<uint8 const*>(&length);
+        buffer.insert(buffer.end(), lengthBytes, lengthBytes + sizeof(length));
+
+        if (!field.IsNull())
+        {
+            uint8 const* value = reinterpret_cast<uint8 const*>(field.data.value);
+            buffer.insert(buffer.end(), value, value + length);
+        }
+    }
+}
+
 bool PreparedResultSet::NextRow()
 {
     /// Only updates the m_rowPosition so upper level code knows in which element
@@ -334,9 +474,103 @@ void ResultSet::CleanUp()
 
     if (_result)
     {
+        // also reads the rows left of an unbuffered result
         mysql_free_result(_result);
         _result = nullptr;
     }
+
+    if (_streamConnection)
+    {
+        _streamConnection->Unlock();
+        _streamConnection = nullptr;
+    }
+
+    _serializedOwner.reset();
+}
+
+static bool IsIntegerType(DatabaseFieldTypes type)
+{
+    switch (type)
+    {
+        case DatabaseFieldTypes::Int8:
+        case DatabaseFieldTypes::Int16:
+        case DatabaseFieldTypes::Int32:
+        case DatabaseFieldTypes::Int64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsRealType(DatabaseFieldTypes type)
+{
+    switch (type)
+    {
+        case DatabaseFieldTypes::Float:
+        case DatabaseFieldTypes::Double:
+        case DatabaseFieldTypes::Decimal:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Values are text, not null terminated for serialized rows
+static int64 ParseInteger(char const* value, uint32 length)
+{
+    char const* end = value + length;
+    bool const negative = value != end && *value == '-';
+    if (negative)
+        ++value;
+
+    uint64 result = 0;
+    for (; value != end && *value >= '0' && *value <= '9'; ++value)
+        result = result * 10 + uint64(*value - '0');
+
+    return int64(negative ? 0 - result : result);
+}
+
+static double ParseReal(char const* value, uint32 length)
+{
+    char buffer[128];
+    length = std::min<uint32>(length, sizeof(buffer) - 1);
+    memcpy(buffer, value, length);
+    buffer[length] = '\0';
+    return strtod(buffer, nullptr);
+}
+
+void ResultColumns::Reset(std::vector<DatabaseFieldTypes> const& types)
+{
+    // arrays are cleared but keep their memory, to decode the next rows of the same result
+    _rowCount = 0;
+    _types = types;
+    _integers.resize(_types.size());
+    _reals.resize(_types.size());
+    for (size_t i = 0; i < _types.size(); ++i)
+    {
+        _integers[i].clear();
+        _reals[i].clear();
+    }
+}
+
+void ResultColumns::AppendValue(uint32 column, char const* value, uint32 length)
+{
+    if (IsIntegerType(_types[column]))
+        _integers[column].push_back(value ? ParseInteger(value, length) : 0);
+    else if (IsRealType(_types[column]))
+        _reals[column].push_back(value ? ParseReal(value, length) : 0.0);
+}
+
+std::vector<int64> const& ResultColumns::GetIntegers(uint32 column) const
+{
+    ASSERT(column < _types.size() && IsIntegerType(_types[column]));
+    return _integers[column];
+}
+
+std::vector<double> const& ResultColumns::GetReals(uint32 column) const
+{
+    ASSERT(column < _types.size() && IsRealType(_types[column]));
+    return _reals[column];
 }
 
 Field const& ResultSet::operator[](std::size_t index) const
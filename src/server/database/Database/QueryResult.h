@@ -23,19 +23,60 @@
 #include "DatabaseEnvFwd.h"
 #include <vector>
 
+enum class DatabaseFieldTypes : uint8;
+class MySQLConnection;
+
+/**
+Block of rows of a ResultSet with numeric columns decoded once into one array per column, see ResultSet::FetchColumns.
+Integer columns are stored as int64 (unsigned bigint values keep their bits), float, double and decimal ones as double.
+NULL values are stored as 0, other column types can't be read this way.
+*/
+class TC_DATABASE_API ResultColumns
+{
+    friend class ResultSet;
+
+    public:
+        uint32 GetRowCount() const { return _rowCount; }
+
+        std::vector<int64> const& GetIntegers(uint32 column) const;
+        std::vector<double> const& GetReals(uint32 column) const;
+
+    private:
+        void Reset(std::vector<DatabaseFieldTypes> const& types);
+        void AppendValue(uint32 column, char const* value, uint32 length);
+
+        uint32 _rowCount = 0;
+        std::vector<DatabaseFieldTypes> _types;
+        std::vector<std::vector<int64>> _integers; // empty for non integer columns
+        std::vector<std::vector<double>> _reals;   // empty for non real columns
+};
+
 class TC_DATABASE_API ResultSet
 {
     public:
-        ResultSet(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount);
+        // streamConnection is given for unbuffered results (see MySQLConnection::StreamQuery), it is unlocked once all rows were read
+        ResultSet(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection = nullptr);
+        // Rows serialized with AppendRow, stored outside of MySQL (see WorldDatabaseSnapshot). owner keeps rows memory alive.
+        ResultSet(std::shared_ptr<void const> owner, uint8 const* rows, size_t size, uint64 rowCount, std::vector<DatabaseFieldTypes> types);
         ~ResultSet();
 
         bool NextRow();
+        // Rows read so far for streamed results
         uint64 GetRowCount() const { return _rowCount; }
         uint32 GetFieldCount() const { return _fieldCount; }
+        bool IsStreamed() const { return _streamed; }
 
         Field* Fetch() const { return _currentRow; }
         Field const& operator[](std::size_t index) const;
 
+        // Decode current row and the following ones, up to maxRows, into columns, instead of converting every field with Field getters.
+        // Returns true if the result is then on a row not decoded yet, as NextRow does.
+        bool FetchColumns(ResultColumns& columns, uint32 maxRows);
+
+        DatabaseFieldTypes GetFieldType(uint32 index) const;
+        // Serialize current row at the end of buffer, in the format expected by the serialized rows constructor
+        void AppendRow(std::vector<uint8>& buffer) const;
+
     protected:
         uint64 _rowCount;
         Field* _currentRow;
@@ -43,8 +84,22 @@ class TC_DATABASE_API ResultSet
 
     private:
         void CleanUp();
+        void SetCurrentRow();
+        bool NextRawRow();
+        bool NextSerializedRow();
         MYSQL_RES* _result;
         MYSQL_FIELD* _fields;
+        MySQLConnection* _streamConnection;
+        bool _streamed;
+
+        // current row values, valid until the next row is read
+        std::vector<char const*> _rawValues;
+        std::vector<uint32> _rawLengths;
+
+        std::shared_ptr<void const> _serializedOwner;
+        uint8 const* _serializedPosition;
+        uint8 const* _serializedEnd;
+        std::vector<DatabaseFieldTypes> _types;
 
         ResultSet(ResultSet const& right) = delete;
         ResultSet& operator=(ResultSet const& right) = delete;
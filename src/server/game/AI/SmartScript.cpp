@@ -20,6 +20,7 @@
 #include "ScriptedCreature.h"
 #include "CreatureTextMgr.h"
 #include "Language.h"
+#include "Tracing.h"
 
 /*
 class TrinityStringTextBuilder 
@@ -4176,6 +4177,8 @@ void SmartScript::OnUpdate(uint32 const diff)
     if ((mScriptType == SMART_SCRIPT_TYPE_CREATURE || mScriptType == SMART_SCRIPT_TYPE_GAMEOBJECT) && !GetBaseObject())
         return;
 
+    TRACE_SCOPE_ARG("script", "SmartScript::OnUpdate", GetBaseObject() ? GetBaseObject()->GetEntry() : 0);
+
     InstallEvents();//before UpdateTimers
 
     for (auto & mEvent : mEvents)
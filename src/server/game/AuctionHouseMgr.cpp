@@ -478,9 +478,9 @@ void AuctionHouseObject::Update()
             itr->second->DeleteFromDB(trans);
 
             sAuctionMgr->RemoveAItem(itr->second->itemGUIDLow);
-            delete itr->second;
-            itr->second = nullptr;
+            AuctionEntry* auction = itr->second;
             RemoveAuction(itr->first);
+            delete auction;
         }
     }
     if(trans->GetSize()) //Sun: don't commit empty transaction
@@ -516,10 +516,9 @@ void AuctionHouseObject::RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::
             itr->second->DeleteFromDB(trans);
 
             sAuctionMgr->RemoveAItem(itr->second->itemGUIDLow);
-            delete itr->second;
-            itr->second = nullptr;
-
+            AuctionEntry* auction = itr->second;
             RemoveAuction(itr->first);
+            delete auction;
         }
     }
 }
@@ -567,45 +566,307 @@ uint32 AuctionHouseObject::GetAuctionsCount(Player* player)
     return totalcount;
 }
 
-void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
-    std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
-    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
-    uint32& count, uint32& totalcount)
+namespace
 {
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin();itr != AuctionsMap.end();++itr)
+    uint32 const AUCTION_SEARCH_ANY = 0xFFFFFFFF;
+
+    std::string GetLocalizedItemName(ItemTemplate const* proto, LocaleConstant locale)
     {
-        AuctionEntry *Aentry = itr->second;
-        Item *item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
-        if (!item)
-            continue;
+        if (locale != DEFAULT_LOCALE)
+            if (ItemLocale const* il = sObjectMgr->GetItemLocale(proto->ItemId))
+                if (il->Name.size() > size_t(locale) && !il->Name[locale].empty())
+                    return il->Name[locale];
 
-        ItemTemplate const *proto = item->GetTemplate();
+        return proto->Name1;
+    }
 
-        if (itemClass != (0xffffffff) && proto->Class != itemClass)
-            continue;
+    // unicode code points fit in 21 bits
+    uint64 MakeTrigram(std::wstring const& str, size_t pos)
+    {
+        return (uint64(str[pos] & 0x1FFFFF) << 42) | (uint64(str[pos + 1] & 0x1FFFFF) << 21) | uint64(str[pos + 2] & 0x1FFFFF);
+    }
+}
 
-        if (itemSubClass != (0xffffffff) && proto->SubClass != itemSubClass)
-            continue;
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    ASSERT(ah);
+    auto itr = AuctionsMap.find(ah->Id);
+    if (itr != AuctionsMap.end())
+        UpdateIndexes(itr->second, false);
 
-        if (inventoryType != (0xffffffff) && proto->InventoryType != inventoryType)
-            continue;
+    AuctionsMap[ah->Id] = ah;
+    UpdateIndexes(ah, true);
+}
 
-        if (quality != (0xffffffff) && proto->Quality != quality)
-            continue;
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    auto itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
 
-        if(    ( levelmin && (proto->RequiredLevel < levelmin) )
-            || ( levelmax && (proto->RequiredLevel > levelmax) ) 
-          )
-            continue;
+    UpdateIndexes(itr->second, false);
+    AuctionsMap.erase(itr);
+    return true;
+}
 
-        if( usable != (0x00) && player->CanUseItem( item ) != EQUIP_ERR_OK )
-            continue;
+void AuctionHouseObject::UpdateIndexes(AuctionEntry const* auction, bool add)
+{
+    _searchResultsCache.clear();
+
+    if (!auction)
+        return;
+
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(auction->itemEntry);
+    if (!proto)
+        return;
+
+    auto update = [&](auto& index, uint32 key)
+    {
+        if (add)
+        {
+            index[key].insert(auction->Id);
+            return;
+        }
+
+        auto itr = index.find(key);
+        if (itr == index.end())
+            return;
+
+        itr->second.erase(auction->Id);
+        if (itr->second.empty())
+            index.erase(itr);
+    };
+
+    if (add && !_auctionsByItemEntry.count(proto->ItemId))
+        for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+            if (_nameIndexes[locale])
+                AddToNameIndex(*_nameIndexes[locale], LocaleConstant(locale), proto->ItemId);
+
+    update(_auctionsByItemEntry, proto->ItemId);
+    update(_auctionsByClass, proto->Class);
+    update(_auctionsBySubClass, (proto->Class << 8) | proto->SubClass);
+    update(_auctionsByInventoryType, proto->InventoryType);
+    update(_auctionsByQuality, proto->Quality);
+    update(_auctionsByRequiredLevel, proto->RequiredLevel);
+}
+
+AuctionHouseObject::ItemNameIndex& AuctionHouseObject::GetNameIndex(LocaleConstant locale)
+{
+    std::unique_ptr<ItemNameIndex>& index = _nameIndexes[locale];
+    if (!index)
+    {
+        index = std::make_unique<ItemNameIndex>();
+        for (auto const& itr : _auctionsByItemEntry)
+            AddToNameIndex(*index, locale, itr.first);
+    }
+
+    return *index;
+}
+
+void AuctionHouseObject::AddToNameIndex(ItemNameIndex& index, LocaleConstant locale, uint32 itemEntry)
+{
+    // items are never removed from the index, the name of an item does not change
+    if (index.names.count(itemEntry))
+        return;
+
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(itemEntry);
+    if (!proto)
+        return;
+
+    std::wstring& name = index.names[itemEntry];
+    if (!Utf8toWStr(GetLocalizedItemName(proto, locale), name))
+        name.clear();
+
+    wstrToLower(name);
+
+    std::unordered_set<uint64> trigrams;
+    for (size_t i = 0; i + 3 <= name.size(); ++i)
+        if (trigrams.insert(MakeTrigram(name, i)).second)
+            index.trigrams[MakeTrigram(name, i)].push_back(itemEntry);
+}
+
+std::vector<uint32> const& AuctionHouseObject::SearchAuctions(LocaleConstant locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality)
+{
+    // locale only matters when searching by name
+    AuctionSearchKey key(wsearchedname.empty() ? uint8(DEFAULT_LOCALE) : uint8(locale), wsearchedname, levelmin, levelmax, inventoryType, itemClass, itemSubClass, quality);
+    auto cached = _searchResultsCache.find(key);
+    if (cached != _searchResultsCache.end())
+        return cached->second;
+
+    if (_searchResultsCache.size() >= MAX_CACHED_SEARCHES)
+        _searchResultsCache.clear();
+
+    std::vector<uint32>& results = _searchResultsCache[key];
+
+    // Every usable index gives the auctions sets that may match, only go through the smallest ones
+    std::vector<AuctionIdSet const*> candidates;
+    size_t candidatesCount = AuctionsMap.size();
+    bool useCandidates = false;
+    auto considerCandidates = [&](std::vector<AuctionIdSet const*>& sets)
+    {
+        size_t count = 0;
+        for (AuctionIdSet const* set : sets)
+            count += set->size();
+
+        if (useCandidates && count >= candidatesCount)
+            return;
+
+        candidates.swap(sets);
+        candidatesCount = count;
+        useCandidates = true;
+    };
+
+    auto considerIndex = [&](AuctionIndex const& index, uint32 indexKey)
+    {
+        std::vector<AuctionIdSet const*> sets;
+        auto itr = index.find(indexKey);
+        if (itr != index.end())
+            sets.push_back(&itr->second);
+        considerCandidates(sets);
+    };
+
+    if (itemClass != AUCTION_SEARCH_ANY)
+    {
+        if (itemSubClass != AUCTION_SEARCH_ANY)
+            considerIndex(_auctionsBySubClass, (itemClass << 8) | itemSubClass);
+        else
+            considerIndex(_auctionsByClass, itemClass);
+    }
+
+    if (inventoryType != AUCTION_SEARCH_ANY)
+        considerIndex(_auctionsByInventoryType, inventoryType);
+
+    if (quality != AUCTION_SEARCH_ANY)
+        considerIndex(_auctionsByQuality, quality);
+
+    if (levelmin || levelmax)
+    {
+        if (levelmax && levelmin > levelmax)
+            return results;
+
+        std::vector<AuctionIdSet const*> sets;
+        auto end = levelmax ? _auctionsByRequiredLevel.upper_bound(levelmax) : _auctionsByRequiredLevel.end();
+        for (auto itr = _auctionsByRequiredLevel.lower_bound(levelmin); itr != end; ++itr)
+            sets.push_back(&itr->second);
+        considerCandidates(sets);
+    }
+
+    std::unordered_set<uint32> matchingEntries;
+    if (!wsearchedname.empty())
+    {
+        ItemNameIndex const& nameIndex = GetNameIndex(locale);
+        auto matchEntry = [&](uint32 itemEntry)
+        {
+            if (!_auctionsByItemEntry.count(itemEntry))
+                return;
+
+            auto name = nameIndex.names.find(itemEntry);
+            if (name != nameIndex.names.end() && name->second.find(wsearchedname) != std::wstring::npos)
+                matchingEntries.insert(itemEntry);
+        };
+
+        if (wsearchedname.size() >= 3)
+        {
+            // only the items having the rarest trigram of the searched name may match
+            std::vector<uint32> const* rarest = nullptr;
+            for (size_t i = 0; i + 3 <= wsearchedname.size(); ++i)
+            {
+                auto itr = nameIndex.trigrams.find(MakeTrigram(wsearchedname, i));
+                if (itr == nameIndex.trigrams.end())
+                    return results;
+
+                if (!rarest || itr->second.size() < rarest->size())
+                    rarest = &itr->second;
+            }
+
+            for (uint32 itemEntry : *rarest)
+                matchEntry(itemEntry);
+        }
+        else
+        {
+            for (auto const& itr : _auctionsByItemEntry)
+                matchEntry(itr.first);
+        }
+
+        std::vector<AuctionIdSet const*> sets;
+        for (uint32 itemEntry : matchingEntries)
+            sets.push_back(&_auctionsByItemEntry[itemEntry]);
+        considerCandidates(sets);
+    }
+
+    auto matches = [&](uint32 auctionId)
+    {
+        AuctionEntry const* auction = GetAuction(auctionId);
+        if (!auction || !sAuctionMgr->GetAItem(auction->itemGUIDLow))
+            return false;
+
+        ItemTemplate const* proto = sObjectMgr->GetItemTemplate(auction->itemEntry);
+        if (!proto)
+            return false;
+
+        if (itemClass != AUCTION_SEARCH_ANY && proto->Class != itemClass)
+            return false;
+
+        if (itemSubClass != AUCTION_SEARCH_ANY && proto->SubClass != itemSubClass)
+            return false;
+
+        if (inventoryType != AUCTION_SEARCH_ANY && proto->InventoryType != inventoryType)
+            return false;
+
+        if (quality != AUCTION_SEARCH_ANY && proto->Quality != quality)
+            return false;
+
+        if ((levelmin && proto->RequiredLevel < levelmin) || (levelmax && proto->RequiredLevel > levelmax))
+            return false;
+
+        // localized names fall back to the default one
+        if (proto->Name1.empty())
+            return false;
+
+        if (!wsearchedname.empty() && !matchingEntries.count(proto->ItemId))
+            return false;
+
+        return true;
+    };
+
+    if (!useCandidates)
+    {
+        for (auto const& itr : AuctionsMap)
+            if (matches(itr.first))
+                results.push_back(itr.first);
+    }
+    else
+    {
+        for (AuctionIdSet const* set : candidates)
+            for (uint32 auctionId : *set)
+                if (matches(auctionId))
+                    results.push_back(auctionId);
+
+        // sets from a same index never overlap
+        if (candidates.size() > 1)
+            std::sort(results.begin(), results.end());
+    }
+
+    return results;
+}
+
+void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
+    std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
+    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
+    uint32& count, uint32& totalcount)
+{
+    std::vector<uint32> const& results = SearchAuctions(player->GetSession()->GetSessionDbLocaleIndex(), wsearchedname, levelmin, levelmax,
+        inventoryType, itemClass, itemSubClass, quality);
 
-        std::string name = player->GetSession()->GetLocalizedItemName(proto);
-        if(name.empty())
+    for (uint32 auctionId : results)
+    {
+        AuctionEntry* Aentry = GetAuction(auctionId);
+        Item* item = Aentry ? sAuctionMgr->GetAItem(Aentry->itemGUIDLow) : nullptr;
+        if (!item)
             continue;
 
-        if( !wsearchedname.empty() && !Utf8FitTo(name, wsearchedname) )
+        if (usable != (0x00) && player->CanUseItem(item) != EQUIP_ERR_OK)
             continue;
 
         if ((count < 50) && (totalcount >= listfrom))
@@ -83,11 +83,7 @@ class AuctionHouseObject
     AuctionEntryMap::iterator GetAuctionsBegin() {return AuctionsMap.begin();}
     AuctionEntryMap::iterator GetAuctionsEnd() {return AuctionsMap.end();}
 
-    void AddAuction(AuctionEntry *ah)
-    {
-        ASSERT( ah );
-        AuctionsMap[ah->Id] = ah;
-    }
+    void AddAuction(AuctionEntry *ah);
 
     AuctionEntry* GetAuction(uint32 id) const
     {
@@ -95,10 +91,7 @@ class AuctionHouseObject
         return itr != AuctionsMap.end() ? itr->second : nullptr;
     }
 
-    bool RemoveAuction(uint32 id)
-    {
-        return AuctionsMap.erase(id) ? true : false;
-    }
+    bool RemoveAuction(uint32 id);
     
     void RemoveAllAuctionsOf(SQLTransaction& trans, ObjectGuid::LowType ownerGUID);
 
@@ -114,6 +107,38 @@ class AuctionHouseObject
 
   private:
     AuctionEntryMap AuctionsMap;
+
+    /* Search indexes, kept up to date by AddAuction/RemoveAuction.
+    Auctions ids are kept ordered like in AuctionsMap, so that search results pages don't change depending on the index used.
+    */
+    typedef std::set<uint32> AuctionIdSet;
+    typedef std::unordered_map<uint32, AuctionIdSet> AuctionIndex;
+
+    AuctionIndex _auctionsByItemEntry;
+    AuctionIndex _auctionsByClass;
+    AuctionIndex _auctionsBySubClass;      // class << 8 | subclass
+    AuctionIndex _auctionsByInventoryType;
+    AuctionIndex _auctionsByQuality;
+    std::map<uint32, AuctionIdSet> _auctionsByRequiredLevel;
+
+    // Lower case localized names of the items ever put in this auction house, with their trigrams. Built on first search in each locale.
+    struct ItemNameIndex
+    {
+        std::unordered_map<uint32 /*itemEntry*/, std::wstring> names;
+        std::unordered_map<uint64 /*trigram*/, std::vector<uint32 /*itemEntry*/>> trigrams;
+    };
+    std::array<std::unique_ptr<ItemNameIndex>, TOTAL_LOCALES> _nameIndexes;
+
+    // Ids of the auctions matching a search, before the "usable" filter since it depends on the player. Cleared whenever an auction is added or removed.
+    typedef std::tuple<uint8 /*locale*/, std::wstring /*name*/, uint32 /*levelmin*/, uint32 /*levelmax*/, uint32 /*inventoryType*/, uint32 /*itemClass*/, uint32 /*itemSubClass*/, uint32 /*quality*/> AuctionSearchKey;
+    std::map<AuctionSearchKey, std::vector<uint32>> _searchResultsCache;
+    static constexpr size_t MAX_CACHED_SEARCHES = 1024;
+
+    void UpdateIndexes(AuctionEntry const* auction, bool add);
+    ItemNameIndex& GetNameIndex(LocaleConstant locale);
+    static void AddToNameIndex(ItemNameIndex& index, LocaleConstant locale, uint32 itemEntry);
+    std::vector<uint32> const& SearchAuctions(LocaleConstant locale, std::wstring const& searchedname, uint32 levelmin, uint32 levelmax,
+        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality);
 };
 
 class TC_GAME_API AuctionHouseMgr
@@ -168,13 +168,53 @@ GameObject* GameObject::GetLinkedTrap()
     return ObjectAccessor::GetGameObject(*this, m_linkedTrap);
 }
 
+uint16 GameObject::GetDynFlagsForTarget(Player* target) const
+{
+    uint16 dynFlags = 0;
+    switch (GetGoType())
+    {
+        case GAMEOBJECT_TYPE_QUESTGIVER:
+            if (ActivateToQuest(target))
+                dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+            break;
+        case GAMEOBJECT_TYPE_CHEST:
+        case GAMEOBJECT_TYPE_GOOBER:
+            if (ActivateToQuest(target))
+                dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+            else if (target->IsGameMaster())
+                dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
+            break;
+        case GAMEOBJECT_TYPE_GENERIC:
+            if (ActivateToQuest(target))
+                dynFlags |= GO_DYNFLAG_LO_SPARKLE;
+            break;
+        default:
+            break;
+    }
+
+    return dynFlags;
+}
+
+bool GameObject::GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const
+{
+    key.visibleFlag = UF_FLAG_PUBLIC;
+    if (GetOwnerGUID() == target->GetGUID())
+        key.visibleFlag |= UF_FLAG_OWNER;
+
+    // see BuildValuesUpdate, GAMEOBJECT_DYN_FLAGS and GAMEOBJECT_FLAGS are the only fields depending on the target
+    key.targetValues[0] = GetDynFlagsForTarget(target);
+    if (GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules)
+        key.targetValues[1] = IsLootAllowedFor(target);
+
+    return true;
+}
+
 void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
 {
     if (!target)
         return;
 
     bool forcedFlags = GetGoType() == GAMEOBJECT_TYPE_CHEST && GetGOInfo()->chest.groupLootRules && HasLootRecipient();
-    bool targetIsGM = target->IsGameMaster();
 
     ByteBuffer fieldBuffer;
 
@@ -197,28 +237,11 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
             //LK if (index == GAMEOBJECT_DYNAMIC)
             if (index == GAMEOBJECT_DYN_FLAGS)
             {
-                uint16 dynFlags = 0;
+                uint16 dynFlags = GetDynFlagsForTarget(target);
 #ifdef LICH_KING
-               //LK int16 pathProgress = -1;
-#endif
+                int16 pathProgress = -1;
                 switch (GetGoType())
                 {
-                    case GAMEOBJECT_TYPE_QUESTGIVER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_CHEST:
-                    case GAMEOBJECT_TYPE_GOOBER:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
-                        else if (targetIsGM)
-                            dynFlags |= GO_DYNFLAG_LO_ACTIVATE;
-                        break;
-                    case GAMEOBJECT_TYPE_GENERIC:
-                        if (ActivateToQuest(target))
-                            dynFlags |= GO_DYNFLAG_LO_SPARKLE;
-                        break;
-#ifdef LICH_KING
                     case GAMEOBJECT_TYPE_TRANSPORT:
                         if (const StaticTransport* t = ToStaticTransport())
                             if (t->GetPauseTime())
@@ -240,10 +263,10 @@ void GameObject::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* t
                         if (const MotionTransport* t = ToMotionTransport())
                             pathProgress = int16(float(t->GetPathProgress()) / float(t->GetPeriod()) * 65535.0f);
                         break;
-#endif
                     default:
                         break;
                 }
+#endif
 
 #ifdef LICH_KING
                 fieldBuffer << uint16(dynFlags);
@@ -518,6 +518,9 @@ class TC_GAME_API GameObject : public WorldObject, public GridObject<GameObject>
         ~GameObject() override;
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        bool GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const override;
+        // GAMEOBJECT_DYN_FLAGS value for given target
+        uint16 GetDynFlagsForTarget(Player* target) const;
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
@@ -981,7 +981,7 @@ Item* Item::CloneItem( uint32 count, Player const* player ) const
     return newItem;
 }
 
-void Item::BuildUpdate(UpdateDataMapType& data_map, UpdatePlayerSet&)
+void Item::BuildUpdate(UpdateDataArena& data_map)
 {
     if (Player* owner = GetOwner())
         BuildFieldsUpdate(owner, data_map);
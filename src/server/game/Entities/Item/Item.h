@@ -335,7 +335,7 @@ class TC_GAME_API Item : public Object
         }
         bool HasInvolvedQuest(uint32 /*quest_id*/) const override { return false; }
 
-        void BuildUpdate(UpdateDataMapType&, UpdatePlayerSet&) override;
+        void BuildUpdate(UpdateDataArena&) override;
 
 		void AddToObjectUpdate() override;
 		void RemoveFromObjectUpdate() override;
@@ -80,6 +80,10 @@ Object::Object() :
     m_inWorld           = false;
     m_isNewObject       = false;
     m_objectUpdated     = false;
+
+    m_updateList        = nullptr;
+    m_updateListPrev    = nullptr;
+    m_updateListNext    = nullptr;
 }
 
 Object::~Object( )
@@ -96,7 +100,7 @@ Object::~Object( )
             ABORT();
         }
 
-        if (m_objectUpdated)
+        if (m_objectUpdated || m_updateList)
         {
             TC_LOG_FATAL("misc", "Object::~Object %u deleted but still in update list!!", GetGUID().GetCounter());
             ABORT();
@@ -202,27 +206,28 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData *data, Player *target) c
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target) const
 {
-    ByteBuffer buf(500);
+    // write directly into update data, this is called for every changed object and every player around it
+    ByteBuffer& buf = data->StartUpdateBlock();
 
     buf << (uint8) UPDATETYPE_VALUES;
     buf << GetPackGUID();
 
     BuildValuesUpdate(UPDATETYPE_VALUES, &buf, target );
+}
 
-    data->AddUpdateBlock(buf);
+bool Object::GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const
+{
+    uint32* flags = nullptr;
+    key.visibleFlag = GetUpdateFieldData(target, flags);
+    return flags != nullptr;
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::BuildFieldsUpdate(Player* player, UpdateDataArena& data_map) const
 {
-    auto iter = data_map.find(player);
-    if (iter == data_map.end())
-    {
-        std::pair<UpdateDataMapType::iterator, bool> p = data_map.emplace(player, UpdateData());
-        ASSERT(p.second);
-        iter = p.first;
-    }
+    if (player->GetSession()->IsPacketIgnored(SMSG_UPDATE_OBJECT))
+        return;
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&data_map.Get(player), player);
 }
 
 uint32 Object::GetUpdateFieldData(Player const* target, uint32*& flags) const
@@ -2645,12 +2650,11 @@ void WorldObject::UpdateObjectVisibility(bool /*forced*/)
 /** Fill UpdateData's for each player in range of given object */
 struct WorldObjectChangeAccumulator
 {
-    UpdateDataMapType& i_updateDatas;
-    UpdatePlayerSet& i_playerSet;
+    UpdateDataArena& i_updateDatas;
     WorldObject& i_object;
-    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d, UpdatePlayerSet &p) : i_updateDatas(d), i_object(obj), i_playerSet(p) 
+    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataArena &d) : i_updateDatas(d), i_object(obj)
     { 
-        i_playerSet.clear();
+        i_updateDatas.NextObject();
     }
 
     void Visit(PlayerMapType &m)
@@ -2706,32 +2710,46 @@ struct WorldObjectChangeAccumulator
         }
     }
 
-    /*todo perf: As I understand it, what changes from player to player is visibility, we build almost the same packet for every players here, this could be vastly improved.
-    Maybe we could:
-    - Do a first pass where we just count players in range that should receive the packet
-    - If that count passes a certain threshold (maybe a very low one like 2-3?), send all those players a packet containing all the changes
-    I think that a client ignore "privates" field it shouldn't receive anyway (like those with UF_OWNER) so that shouldn't cause problems
-    */
     void BuildPacket(Player* player)
     {
+        if (!player->HaveAtClient(&i_object))
+            return;
+
+        // bots don't read values updates
+        if (player->GetSession()->IsPacketIgnored(SMSG_UPDATE_OBJECT))
+            return;
+
         // Only send update once to a player
-        if (i_playerSet.find(player->GetGUID().GetCounter()) == i_playerSet.end() && player->HaveAtClient(&i_object))
+        UpdateData* data = i_updateDatas.GetForCurrentObject(player);
+        if (!data)
+            return;
+
+        // Most players around see the same fields, build the block once per viewer key and copy it for the others
+        ValuesUpdateViewerKey key;
+        if (!i_object.GetValuesUpdateViewerKey(player, key))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
-            i_playerSet.insert(player->GetGUID().GetCounter());
+            i_object.BuildValuesUpdateBlockForPlayer(data, player);
+            return;
         }
+
+        if (i_updateDatas.AppendSharedBlock(key, *data))
+            return;
+
+        size_t const blockStart = data->GetDataSize();
+        i_object.BuildValuesUpdateBlockForPlayer(data, player);
+        i_updateDatas.ShareBlock(key, *data, blockStart);
     }
 
     template<class SKIP> void Visit(GridRefManager<SKIP> &) { }
 };
 
-void WorldObject::BuildUpdate(UpdateDataMapType& data_map, UpdatePlayerSet& player_set)
+void WorldObject::BuildUpdate(UpdateDataArena& data_map)
 {
     CellCoord p = Trinity::ComputeCellCoord(GetPositionX(), GetPositionY());
     Cell cell(p);
     cell.SetNoCreate();
 
-    WorldObjectChangeAccumulator notifier(*this, data_map, player_set);
+    WorldObjectChangeAccumulator notifier(*this, data_map);
     TypeContainerVisitor<WorldObjectChangeAccumulator, WorldTypeMapContainer > player_notifier(notifier);
     Map& map = *GetMap();
     //we must build packets for all visible players
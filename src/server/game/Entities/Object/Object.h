@@ -24,6 +24,7 @@ uint32 GuidHigh2TypeId(HighGuid guid_hi);
 
 class WorldPacket;
 class UpdateData;
+class UpdateObjectList;
 class Creature;
 class Player;
 class InstanceScript;
@@ -42,8 +43,6 @@ namespace G3D
     class Vector3;
 }
 
-typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
-typedef std::unordered_set<uint32> UpdatePlayerSet;
 
 float const DEFAULT_COLLISION_HEIGHT = 2.03128f; // Most common value in dbc
 
@@ -190,6 +189,11 @@ class TC_GAME_API Object
             Fill the update data with update(s) for given target (the updates are about the data of this object)
         */
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        /**
+            Fill key with everything the values update for given target depends on. Targets with the same key get the same values update block,
+            so that it can be built only once. Return false if the update cannot be shared with other targets.
+        */
+        virtual bool GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const;
         /**
             Mark this object for destroying at client in update data
         */
@@ -255,14 +259,13 @@ class TC_GAME_API Object
         void SetIsNewObject(bool enable) { m_isNewObject = enable; }
         /** 
             Visits cells around the object, fill players UpdateData with updates from this object if needed
-			player_set is there for performance only, since this function is called a lot, this helps avoiding recreating it at each call. Content is not important and is cleared at each call.
         */
-        virtual void BuildUpdate(UpdateDataMapType&, UpdatePlayerSet& player_set) { }
+        virtual void BuildUpdate(UpdateDataArena&) { }
         /**
            Adds the player and update data for him to the given updateData map. 
            Creates the update map for him if it doesn't exists, else exists the already existing one.
         */
-        void BuildFieldsUpdate(Player*, UpdateDataMapType& data_map) const;
+        void BuildFieldsUpdate(Player*, UpdateDataArena& data_map) const;
 
         /** Force notify of all update fields having this flag. Don't forget to remove it afterwards. */
         void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
@@ -333,6 +336,12 @@ class TC_GAME_API Object
         bool m_objectUpdated;
 
     private:
+        friend class UpdateObjectList;
+        // links in the map list of objects with pending changes, see UpdateObjectList
+        UpdateObjectList* m_updateList;
+        Object* m_updateListPrev;
+        Object* m_updateListNext;
+
         bool m_inWorld;
         bool m_isNewObject;
 
@@ -702,7 +711,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         // Event handler
         EventProcessor m_Events;
 
-        void BuildUpdate(UpdateDataMapType&, UpdatePlayerSet& player_set) override;
+        void BuildUpdate(UpdateDataArena&) override;
 
 		void AddToObjectUpdate() override;
 		void RemoveFromObjectUpdate() override;
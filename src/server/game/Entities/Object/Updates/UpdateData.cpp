@@ -26,29 +26,85 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+namespace
 {
-    z_stream c_stream;
+    /** deflate stream kept by each thread compressing update packets, so that zlib state is not allocated and freed for every packet */
+    class ThreadDeflateStream
+    {
+        public:
+            ThreadDeflateStream() : _initialized(false), _level(0) { }
+            ~ThreadDeflateStream()
+            {
+                if (_initialized)
+                    deflateEnd(&_stream);
+            }
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+            /** Get stream ready to compress a new packet, or nullptr on error */
+            z_stream* Get(int level)
+            {
+                if (_initialized && _level != level) // compression level changed with config reload
+                {
+                    deflateEnd(&_stream);
+                    _initialized = false;
+                }
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+                if (_initialized)
+                {
+                    int z_res = deflateReset(&_stream);
+                    if (z_res == Z_OK)
+                        return &_stream;
+
+                    TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+                    deflateEnd(&_stream);
+                    _initialized = false;
+                }
+
+                _stream.zalloc = (alloc_func)nullptr;
+                _stream.zfree = (free_func)nullptr;
+                _stream.opaque = (voidpf)nullptr;
+
+                int z_res = deflateInit(&_stream, level);
+                if (z_res != Z_OK)
+                {
+                    TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                    return nullptr;
+                }
+
+                _initialized = true;
+                _level = level;
+                return &_stream;
+            }
+
+        private:
+            z_stream _stream;
+            bool _initialized;
+            int _level;
+    };
+
+    thread_local ThreadDeflateStream threadDeflateStream;
+}
+
+void UpdateData::AddUpdateBlock(uint8 const* block, size_t size)
+{
+    m_data.append(block, size);
+    ++m_blockCount;
+}
+
+void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
+    z_stream* c_stream = threadDeflateStream.Get(sWorld->getConfig(CONFIG_COMPRESSION));
+    if (!c_stream)
     {
-        TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflateInit) Error code: %i (%s)",z_res,zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate) Error code: %i (%s)",z_res,zError(z_res));
@@ -56,14 +112,14 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)",z_res,zError(z_res));
@@ -71,15 +127,23 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        TC_LOG_ERROR("misc","Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)",z_res,zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    *dst_size = c_stream->total_out;
+}
 
-    *dst_size = c_stream.total_out;
+bool UpdateData::CompressPacket(ByteBuffer const& src, WorldPacket* packet)
+{
+    size_t const srcSize = src.wpos();                      // use real used data size
+    uint32 destsize = compressBound(srcSize);
+    packet->resize(destsize + sizeof(uint32));
+
+    packet->put(0, (uint32)src.size());
+    Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)src.contents(), srcSize);
+    if (destsize == 0)
+        return false;
+
+    packet->resize( destsize + sizeof(uint32) );
+    packet->SetOpcode( SMSG_COMPRESSED_UPDATE_OBJECT );
+    return true;
 }
 
 bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
@@ -102,34 +166,119 @@ bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
 
     buf.append(m_data);
 
-    size_t pSize = buf.wpos();                              // use real used data size
+    // With CONFIG_COMPRESSION_IN_NETWORK_THREADS, packet is sent uncompressed to the socket which will compress it, see WorldSocket::Update
+    if (m_data.size() > COMPRESSION_THRESHOLD && !sWorld->getBoolConfig(CONFIG_COMPRESSION_IN_NETWORK_THREADS))
+        return CompressPacket(buf, packet);
 
-    if (m_data.size() > 100 )
-    {
-        uint32 destsize = compressBound(pSize);
-        packet->resize(destsize + sizeof(uint32));
+    packet->append(buf);
+    packet->SetOpcode( SMSG_UPDATE_OBJECT );
+    return true;
+}
 
-        packet->put(0, (uint32)buf.size());
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-        if (destsize == 0)
-            return false;
+void UpdateData::Clear()
+{
+    m_data.clear();
+    m_outOfRangeGUIDs.clear();
+    m_blockCount = 0;
+}
 
-        packet->resize( destsize + sizeof(uint32) );
-        packet->SetOpcode( SMSG_COMPRESSED_UPDATE_OBJECT );
+
+UpdateDataArena::Entry& UpdateDataArena::GetEntry(Player* player)
+{
+    auto itr = _indexes.find(player);
+    if (itr != _indexes.end())
+        return _entries[itr->second];
+
+    uint32 index;
+    if (!_freeEntries.empty())
+    {
+        index = _freeEntries.back();
+        _freeEntries.pop_back();
     }
     else
     {
-        packet->append(buf);
-        packet->SetOpcode( SMSG_UPDATE_OBJECT );
+        index = _entries.size();
+        _entries.emplace_back();
     }
 
-    return true;
+    _indexes[player] = index;
+    Entry& entry = _entries[index];
+    entry.player = player;
+    entry.index = index;
+    return entry;
 }
 
-void UpdateData::Clear()
+void UpdateDataArena::NextObject()
 {
-    m_data.clear();
-    m_outOfRangeGUIDs.clear();
-    m_blockCount = 0;
+    ++_objectStamp;
+    _sharedBlocks.clear();
+    _sharedBlocksData.clear();
 }
 
+bool UpdateDataArena::AppendSharedBlock(ValuesUpdateViewerKey const& key, UpdateData& data) const
+{
+    for (SharedBlock const& block : _sharedBlocks)
+    {
+        if (block.key == key)
+        {
+            data.AddUpdateBlock(_sharedBlocksData.contents() + block.offset, block.size);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UpdateDataArena::ShareBlock(ValuesUpdateViewerKey const& key, UpdateData const& data, size_t blockStart)
+{
+    // keys are compared one by one, don't let this grow for objects seen differently by each player
+    if (_sharedBlocks.size() >= MAX_SHARED_BLOCKS_PER_OBJECT)
+        return;
+
+    SharedBlock block;
+    block.key = key;
+    block.offset = _sharedBlocksData.wpos();
+    block.size = data.GetDataSize() - blockStart;
+    _sharedBlocksData.append(data.GetData() + blockStart, block.size);
+    _sharedBlocks.push_back(block);
+}
+
+UpdateData& UpdateDataArena::Get(Player* player)
+{
+    Entry& entry = GetEntry(player);
+    if (!entry.used)
+    {
+        entry.used = true;
+        _usedEntries.push_back(entry.index);
+    }
+    return entry.data;
+}
+
+UpdateData* UpdateDataArena::GetForCurrentObject(Player* player)
+{
+    Entry& entry = GetEntry(player);
+    if (entry.objectStamp == _objectStamp)
+        return nullptr;
+
+    entry.objectStamp = _objectStamp;
+    return &Get(player);
+}
+
+void UpdateDataArena::RemovePlayer(Player* player)
+{
+    auto itr = _indexes.find(player);
+    if (itr == _indexes.end())
+        return;
+
+    Entry& entry = _entries[itr->second];
+    if (entry.used)
+    {
+        _usedEntries.erase(std::find(_usedEntries.begin(), _usedEntries.end(), entry.index));
+        entry.data.Clear();
+        entry.used = false;
+    }
+    entry.player = nullptr;
+    entry.objectStamp = 0;
+    _freeEntries.push_back(itr->second);
+    _indexes.erase(itr);
+}
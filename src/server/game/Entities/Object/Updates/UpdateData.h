@@ -3,7 +3,10 @@
 #define __UPDATEDATA_H
 
 #include "ObjectGuid.h"
+#include <array>
+#include <deque>
 class WorldPacket;
+class Player;
 enum ClientBuild : uint32;
 
 enum OBJECT_UPDATE_TYPE
@@ -49,21 +52,116 @@ class UpdateData
         void AddOutOfRangeGUID(std::set<ObjectGuid>& guids);
         void AddOutOfRangeGUID(const ObjectGuid &guid);
         void AddUpdateBlock(const ByteBuffer &block);
+        void AddUpdateBlock(uint8 const* block, size_t size);
+        /** Start a new update block and return the buffer to write it into. Avoids building the block in a temporary buffer first. */
+        ByteBuffer& StartUpdateBlock() { ++m_blockCount; return m_data; }
         /** Build a WorldPacket from this update data 
             @packet an unitialized WorldPacket
         */
         bool BuildPacket(WorldPacket* packet, bool hasTransport);
+        /** Compress an uncompressed update packet content into a SMSG_COMPRESSED_UPDATE_OBJECT packet
+            @packet an unitialized WorldPacket
+        */
+        static bool CompressPacket(ByteBuffer const& src, WorldPacket* packet);
+        /** Update packets with more data than this are compressed */
+        static constexpr size_t COMPRESSION_THRESHOLD = 100;
         bool HasData() { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
+        size_t GetDataSize() const { return m_data.wpos(); }
+        uint8 const* GetData() const { return m_data.contents(); }
 
     protected:
         uint32 m_blockCount;  //one per object updated
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
-        void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        static void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+};
+
+/**
+    Everything a values update of an object depends on for a given target. Targets with the same key receive the exact same values update block,
+    see Object::GetValuesUpdateViewerKey
+*/
+struct ValuesUpdateViewerKey
+{
+    ValuesUpdateViewerKey() : visibleFlag(0), targetValues() { }
+
+    bool operator==(ValuesUpdateViewerKey const& other) const { return visibleFlag == other.visibleFlag && targetValues == other.targetValues; }
+
+    uint32 visibleFlag;
+    std::array<uint32, 8> targetValues; // values sent for the fields depending on the target, if any
+};
+
+/**
+    One UpdateData per player, kept from one update to the next.
+    UpdateData's are cleared after use instead of destroyed, so that their buffers are reused and no map is rebuilt at each update.
+*/
+class UpdateDataArena
+{
+    public:
+        UpdateDataArena() : _objectStamp(0) { }
+
+        /** Get UpdateData for given player, creating it if needed */
+        UpdateData& Get(Player* player);
+        /** Start building updates for a new object, see GetForCurrentObject */
+        void NextObject();
+        /** Same as Get, but returns nullptr if player was already returned for the current object */
+        UpdateData* GetForCurrentObject(Player* player);
+
+        /** Call worker(Player*, UpdateData&) for each player with pending data, then clear those data */
+        template<class Worker>
+        void Consume(Worker&& worker)
+        {
+            for (uint32 index : _usedEntries)
+            {
+                Entry& entry = _entries[index];
+                worker(entry.player, entry.data);
+                entry.data.Clear();
+                entry.used = false;
+            }
+            _usedEntries.clear();
+        }
+
+        /** Append values block already built for the current object for given viewer key to data, if any */
+        bool AppendSharedBlock(ValuesUpdateViewerKey const& key, UpdateData& data) const;
+        /** Keep the values block built in data from blockStart for the current object, for the next targets with the same viewer key */
+        void ShareBlock(ValuesUpdateViewerKey const& key, UpdateData const& data, size_t blockStart);
+
+        /** Forget player storage, must be called before player pointer becomes invalid */
+        void RemovePlayer(Player* player);
+
+    private:
+        struct Entry
+        {
+            Entry() : player(nullptr), index(0), used(false), objectStamp(0) { }
+
+            Player* player;
+            uint32 index;
+            UpdateData data;
+            bool used;
+            uint32 objectStamp;
+        };
+
+        struct SharedBlock
+        {
+            ValuesUpdateViewerKey key;
+            size_t offset;
+            size_t size;
+        };
+
+        Entry& GetEntry(Player* player);
+
+        static constexpr size_t MAX_SHARED_BLOCKS_PER_OBJECT = 16;
+
+        std::unordered_map<Player*, uint32 /*entry index*/> _indexes;
+        std::deque<Entry> _entries; // deque so that entries never move
+        std::vector<uint32> _freeEntries;
+        std::vector<uint32> _usedEntries;
+        uint32 _objectStamp;
+        std::vector<SharedBlock> _sharedBlocks;
+        ByteBuffer _sharedBlocksData;
 };
 #endif
 
@@ -0,0 +1,50 @@
+
+#include "UpdateObjectList.h"
+#include "Object.h"
+
+void UpdateObjectList::Add(Object* obj)
+{
+    if (obj->m_updateList == this)
+        return;
+
+    ASSERT(obj->m_updateList == nullptr);
+
+    obj->m_updateList = this;
+    obj->m_updateListPrev = nullptr;
+    obj->m_updateListNext = _head;
+    if (_head)
+        _head->m_updateListPrev = obj;
+    _head = obj;
+}
+
+void UpdateObjectList::Remove(Object* obj)
+{
+    if (obj->m_updateList != this)
+        return;
+
+    if (obj->m_updateListPrev)
+        obj->m_updateListPrev->m_updateListNext = obj->m_updateListNext;
+    else
+        _head = obj->m_updateListNext;
+
+    if (obj->m_updateListNext)
+        obj->m_updateListNext->m_updateListPrev = obj->m_updateListPrev;
+
+    obj->m_updateList = nullptr;
+    obj->m_updateListPrev = nullptr;
+    obj->m_updateListNext = nullptr;
+}
+
+Object* UpdateObjectList::PopFront()
+{
+    Object* obj = _head;
+    if (obj)
+        Remove(obj);
+
+    return obj;
+}
+
+void UpdateObjectList::Clear()
+{
+    while (PopFront());
+}
@@ -0,0 +1,38 @@
+
+#ifndef __UPDATEOBJECTLIST_H
+#define __UPDATEOBJECTLIST_H
+
+#include "Define.h"
+
+class Object;
+
+/**
+    Intrusive list of objects having pending changes to send.
+    Links are stored in the objects themselves, so that adding or removing an object never allocates and is O(1).
+    An object can only be in one list at a time.
+*/
+class UpdateObjectList
+{
+    public:
+        UpdateObjectList() : _head(nullptr) { }
+        ~UpdateObjectList() { Clear(); }
+
+        UpdateObjectList(UpdateObjectList const&) = delete;
+        UpdateObjectList& operator=(UpdateObjectList const&) = delete;
+
+        /** Add object at the front of the list, does nothing if it is already in this list */
+        void Add(Object* obj);
+        /** Remove object from the list, does nothing if it is not in this list */
+        void Remove(Object* obj);
+        /** Unlink and return the first object of the list, or nullptr if empty */
+        Object* PopFront();
+        /** Unlink all objects */
+        void Clear();
+
+        bool IsEmpty() const { return _head == nullptr; }
+
+    private:
+        Object* _head;
+};
+
+#endif
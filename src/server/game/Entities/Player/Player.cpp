@@ -6197,6 +6197,11 @@ void Player::SendDirectMessage(WorldPacket const* data) const
     GetSession()->SendPacket(data);
 }
 
+void Player::SendDirectMessage(SharedWorldPacket const& data) const
+{
+    GetSession()->SendPacket(data);
+}
+
 void Player::SendCinematicStart(uint32 CinematicSequenceId) const
 {
     WorldPacket data(SMSG_TRIGGER_CINEMATIC, 4);
@@ -15032,6 +15037,7 @@ void Player::_LoadBGData(PreparedQueryResult result)
     m_bgData.taxiPath[0] = fields[7].GetUInt32();
     m_bgData.taxiPath[1] = fields[8].GetUInt32();
     m_bgData.mountSpell = fields[9].GetUInt32();
+    m_savedBGData = m_bgData;
 }
 
 bool Player::LoadPositionFromDB(uint32& mapid, float& x,float& y,float& z,float& o, bool& in_flight, ObjectGuid guid)
@@ -17126,6 +17132,45 @@ bool Player::_LoadHomeBind(PreparedQueryResult result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+#define PLAYER_SAVE_BATCH_ROWS 500
+
+// Groups rows of a save section into multi rows statements (head, then rows separated by ',', then tail).
+// A statement is appended to the transaction every PLAYER_SAVE_BATCH_ROWS rows and for the remaining rows on destruction.
+class PlayerSaveBatch
+{
+public:
+    PlayerSaveBatch(SQLTransaction& trans, std::string&& head, char const* tail = "") : _trans(trans), _head(std::move(head)), _tail(tail), _rows(0) { }
+    ~PlayerSaveBatch() { Flush(); }
+
+    template<typename Format, typename... Args>
+    void AddRow(Format&& row, Args&&... args)
+    {
+        if (_rows == PLAYER_SAVE_BATCH_ROWS)
+            Flush();
+
+        _sql += _rows++ ? "," : _head;
+        _sql += Trinity::StringFormat(std::forward<Format>(row), std::forward<Args>(args)...);
+    }
+
+private:
+    void Flush()
+    {
+        if (!_rows)
+            return;
+
+        _sql += _tail;
+        _trans->Append(_sql.c_str());
+        _sql.clear();
+        _rows = 0;
+    }
+
+    SQLTransaction& _trans;
+    std::string _head;
+    char const* _tail;
+    std::string _sql;
+    uint32 _rows;
+};
+
 void Player::SaveToDB(bool create /*=false*/)
 {
     // delay auto save at any saves (manual, in code, or autosave)
@@ -17272,6 +17317,7 @@ void Player::SaveToDB(bool create /*=false*/)
     }
     else
     {
+        // No dirty tracking for the character row: played time and logout time change between any two saves
         /*PrepareStatement(CHAR_UPD_CHARACTER, "UPDATE characters SET name=?,race=?,class=?,gender=?,level=?,xp=?,money=?,playerBytes=?,playerBytes2=?,playerFlags=?,"
             "map=?,instance_id=?,dungeon_difficulty=?,position_x=?,position_y=?,position_z=?,orientation=?,trans_x=?,trans_y=?,trans_z=?,trans_o=?,transguid=?,taximask=?,cinematic=?,totaltime=?,leveltime=?,rest_bonus=?,"
             "logout_time=?,is_logout_resting=?,resettalents_cost=?,resettalents_time=?,extra_flags=?,stable_slots=?,at_login=?,zone=?,death_expire_time=?,taxi_path=?,"
@@ -17423,7 +17469,7 @@ void Player::SaveToDB(bool create /*=false*/)
     _SaveSpells(trans);
     GetSpellHistory()->SaveToDB<Player>(trans);
     _SaveActions(trans);
-    _SaveAuras(trans);
+    _SaveAuras(trans);                                      // always rewritten, remaining durations change all the time
     _SaveSkills(trans);
     m_reputationMgr->SaveToDB(trans);
     GetSession()->SaveTutorialsData(trans);                 // changed only while character in game
@@ -17456,24 +17502,22 @@ void Player::SaveGoldToDB(SQLTransaction trans)
 
 void Player::_SaveActions(SQLTransaction trans)
 {
+    PlayerSaveBatch replaced(trans, "REPLACE INTO character_action (guid,button,action,type,misc) VALUES ");
+    PlayerSaveBatch deleted(trans, Trinity::StringFormat("DELETE FROM character_action WHERE guid = '%u' AND button IN (", GetGUID().GetCounter()), ")");
+
     for(auto itr = m_actionButtons.begin(); itr != m_actionButtons.end(); )
     {
         switch (itr->second.uState)
         {
             case ACTIONBUTTON_NEW:
-                trans->PAppend("INSERT INTO character_action (guid,button,action,type,misc) VALUES ('%u', '%u', '%u', '%u', '%u')",
-                    GetGUID().GetCounter(), (uint32)itr->first, (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc );
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-                break;
             case ACTIONBUTTON_CHANGED:
-                trans->PAppend("UPDATE character_action  SET action = '%u', type = '%u', misc= '%u' WHERE guid= '%u' AND button= '%u' ",
-                    (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc, GetGUID().GetCounter(), (uint32)itr->first );
+                replaced.AddRow("('%u', '%u', '%u', '%u', '%u')",
+                    GetGUID().GetCounter(), (uint32)itr->first, (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc );
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
                 break;
             case ACTIONBUTTON_DELETED:
-                trans->PAppend("DELETE FROM character_action WHERE guid = '%u' and button = '%u'", GetGUID().GetCounter(), (uint32)itr->first );
+                deleted.AddRow("'%u'", (uint32)itr->first);
                 m_actionButtons.erase(itr++);
                 break;
             default:
@@ -17489,6 +17533,9 @@ void Player::_SaveAuras(SQLTransaction trans)
     stmt->setUInt32(0, GetGUID().GetCounter());
     trans->Append(stmt);
 
+    PlayerSaveBatch inserted(trans, "INSERT INTO character_aura (guid, casterGuid, itemGuid, spell, effectMask, recalculateMask, stackCount, amount0, amount1, amount2, "
+        "base_amount0, base_amount1, base_amount2, maxDuration, remainTime, remainCharges, critChance, applyResilience) VALUES ");
+
     for (AuraMap::const_iterator itr = m_ownedAuras.begin(); itr != m_ownedAuras.end(); ++itr)
     {
         if (!itr->second->CanBeSaved())
@@ -17517,32 +17564,19 @@ void Player::_SaveAuras(SQLTransaction trans)
             }
         }
 
-        uint8 index = 0;
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA);
-        stmt->setUInt32(index++, GetGUID().GetCounter());
-        stmt->setUInt64(index++, itr->second->GetCasterGUID().GetRawValue());
-        stmt->setUInt64(index++, itr->second->GetCastItemGUID().GetRawValue());
-        stmt->setUInt32(index++, itr->second->GetId());
-        stmt->setUInt8(index++, effMask);
-        stmt->setUInt8(index++, recalculateMask);
-        stmt->setUInt8(index++, itr->second->GetStackAmount());
-        stmt->setInt32(index++, damage[0]);
-        stmt->setInt32(index++, damage[1]);
-        stmt->setInt32(index++, damage[2]);
-        stmt->setInt32(index++, baseDamage[0]);
-        stmt->setInt32(index++, baseDamage[1]);
-        stmt->setInt32(index++, baseDamage[2]);
-        stmt->setInt32(index++, itr->second->GetMaxDuration());
-        stmt->setInt32(index++, itr->second->GetDuration());
-        stmt->setUInt8(index++, itr->second->GetCharges());
-        stmt->setFloat(index++, itr->second->GetCritChance());
-        stmt->setBool(index++, itr->second->CanApplyResilience());
-        trans->Append(stmt);
+        inserted.AddRow("(%u, " UI64FMTD ", " UI64FMTD ", %u, %u, %u, %u, %i, %i, %i, %i, %i, %i, %i, %i, %u, %f, %u)",
+            GetGUID().GetCounter(), aura->GetCasterGUID().GetRawValue(), aura->GetCastItemGUID().GetRawValue(), aura->GetId(),
+            uint32(effMask), uint32(recalculateMask), uint32(aura->GetStackAmount()),
+            damage[0], damage[1], damage[2], baseDamage[0], baseDamage[1], baseDamage[2],
+            aura->GetMaxDuration(), aura->GetDuration(), uint32(aura->GetCharges()), aura->GetCritChance(), uint32(aura->CanApplyResilience()));
     }
 }
 
 void Player::_SaveBGData(SQLTransaction& trans)
 {
+    if (m_savedBGData && m_bgData.HasSameSavedData(*m_savedBGData))
+        return;
+
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYER_BGDATA);
     stmt->setUInt32(0, GetGUID().GetCounter());
     trans->Append(stmt);
@@ -17560,6 +17594,8 @@ void Player::_SaveBGData(SQLTransaction& trans)
     stmt->setUInt16(9, m_bgData.taxiPath[1]);
     stmt->setUInt16(10, m_bgData.mountSpell);
     trans->Append(stmt);
+
+    m_savedBGData = m_bgData;
 }
 
 void Player::_SaveInventory(SQLTransaction trans)
@@ -17884,6 +17920,9 @@ void Player::_SaveSeasonalQuestStatus(SQLTransaction& trans)
 
 void Player::_SaveSkills(SQLTransaction trans)
 {
+    PlayerSaveBatch replaced(trans, "REPLACE INTO character_skills (guid, skill, value, max) VALUES ");
+    PlayerSaveBatch deleted(trans, Trinity::StringFormat("DELETE FROM character_skills WHERE guid = '%u' AND skill IN (", GetGUID().GetCounter()), ")");
+
     for( auto itr = mSkillStatus.begin(); itr != mSkillStatus.end(); )
     {
         if(itr->second.uState == SKILL_UNCHANGED)
@@ -17894,7 +17933,7 @@ void Player::_SaveSkills(SQLTransaction trans)
 
         if(itr->second.uState == SKILL_DELETED)
         {
-            trans->PAppend("DELETE FROM character_skills WHERE guid = '%u' AND skill = '%u' ", GetGUID().GetCounter(), itr->first );
+            deleted.AddRow("'%u'", itr->first);
             mSkillStatus.erase(itr++);
             continue;
         }
@@ -17903,19 +17942,7 @@ void Player::_SaveSkills(SQLTransaction trans)
         uint16 value = SKILL_VALUE(valueData);
         uint16 max = SKILL_MAX(valueData);
 
-        switch (itr->second.uState)
-        {
-            case SKILL_NEW:
-                trans->PAppend("INSERT INTO character_skills (guid, skill, value, max) VALUES ('%u', '%u', '%u', '%u')",
-                    GetGUID().GetCounter(), itr->first, value, max);
-                break;
-            case SKILL_CHANGED:
-                trans->PAppend("UPDATE character_skills SET value = '%u',max = '%u'WHERE guid = '%u' AND skill = '%u' ",
-                    value, max, GetGUID().GetCounter(), itr->first );
-                break;
-            default:
-                break;
-        };
+        replaced.AddRow("('%u', '%u', '%u', '%u')", GetGUID().GetCounter(), itr->first, value, max);
         itr->second.uState = SKILL_UNCHANGED;
 
         ++itr;
@@ -17924,15 +17951,18 @@ void Player::_SaveSkills(SQLTransaction trans)
 
 void Player::_SaveSpells(SQLTransaction trans)
 {
+    PlayerSaveBatch replaced(trans, "REPLACE INTO character_spell (guid,spell,active,disabled) VALUES ");
+    PlayerSaveBatch deleted(trans, Trinity::StringFormat("DELETE FROM character_spell WHERE guid = '%u' AND spell IN (", GetGUID().GetCounter()), ")");
+
     for (PlayerSpellMap::const_iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end(); itr = next)
     {
         ++next;
-        if (itr->second->state == PLAYERSPELL_REMOVED || itr->second->state == PLAYERSPELL_CHANGED)
-            trans->PAppend("DELETE FROM character_spell WHERE guid = '%u' and spell = '%u'", GetGUID().GetCounter(), itr->first);
+        if (itr->second->state == PLAYERSPELL_REMOVED)
+            deleted.AddRow("'%u'", itr->first);
 
         // add only changed/new not dependent spells
         if ((!itr->second->dependent && itr->second->state == PLAYERSPELL_NEW) || itr->second->state == PLAYERSPELL_CHANGED)
-            trans->PAppend("INSERT INTO character_spell (guid,spell,active,disabled) VALUES ('%u','%u','%u','%u')", GetGUID().GetCounter(), itr->first, uint32(itr->second->active), uint32(itr->second->disabled));
+            replaced.AddRow("('%u','%u','%u','%u')", GetGUID().GetCounter(), itr->first, uint32(itr->second->active), uint32(itr->second->disabled));
 
         if (itr->second->state == PLAYERSPELL_REMOVED)
             _removeSpell(itr->first);
@@ -23271,16 +23301,15 @@ void Player::SetViewpoint(WorldObject* target, bool apply)
     {
         if (apply)
         {
-            UpdateDataMapType update_players;
-            UpdatePlayerSet player_set; //only there for performance, avoid recreating it at each BuildUpdate call
-            BuildUpdate(update_players, player_set);
+            UpdateDataArena update_players;
+            BuildUpdate(update_players);
             WorldPacket packet;
-            for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+            update_players.Consume([&packet](Player* player, UpdateData& data)
             {
-                iter->second.BuildPacket(&packet);
-                iter->first->GetSession()->SendPacket(&packet);
+                data.BuildPacket(&packet);
+                player->GetSession()->SendPacket(&packet);
                 packet.clear();
-            }
+            });
         }
         else
         {
@@ -1105,6 +1105,15 @@ struct BGData
 
     void ClearTaxiPath() { taxiPath[0] = taxiPath[1] = 0; }
     bool HasTaxiPath() const { return taxiPath[0] && taxiPath[1]; }
+
+    // Compare only what is stored in character_battleground_data
+    bool HasSameSavedData(BGData const& other) const
+    {
+        return bgInstanceID == other.bgInstanceID && bgTeam == other.bgTeam && mountSpell == other.mountSpell
+            && taxiPath[0] == other.taxiPath[0] && taxiPath[1] == other.taxiPath[1] && joinPos.GetMapId() == other.joinPos.GetMapId()
+            && joinPos.GetPositionX() == other.joinPos.GetPositionX() && joinPos.GetPositionY() == other.joinPos.GetPositionY()
+            && joinPos.GetPositionZ() == other.joinPos.GetPositionZ() && joinPos.GetOrientation() == other.joinPos.GetOrientation();
+    }
 };
 
 struct TradeStatusInfo
@@ -2114,6 +2123,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SendInitWorldStates(uint32 zoneid, uint32 areaid);
 		void SendUpdateWorldState(uint32 variable, uint32 value) const;
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(SharedWorldPacket const& data) const;
 
         void SendAuraDurationsForTarget(Unit* target);
 
@@ -2454,6 +2464,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         };
         BgBattlegroundQueueID_Rec m_bgBattlegroundQueueID[PLAYER_MAX_BATTLEGROUND_QUEUES];
         BGData                    m_bgData;
+        Optional<BGData>          m_savedBGData; // as currently in db, if known
 
 #ifdef LICH_KING
         bool m_IsBGRandomWinner; //NYI
@@ -133,7 +133,7 @@ void MotionTransport::CleanupsBeforeDelete(bool finalCleanup /*= true*/)
     GameObject::CleanupsBeforeDelete(finalCleanup);
 }
 
-void MotionTransport::BuildUpdate(UpdateDataMapType& data_map, UpdatePlayerSet&)
+void MotionTransport::BuildUpdate(UpdateDataArena& data_map)
 {
     Map::PlayerList const& players = GetMap()->GetPlayers();
     if (players.isEmpty())
@@ -888,7 +888,7 @@ void StaticTransport::CleanupsBeforeDelete(bool finalCleanup /*= true*/)
     GameObject::CleanupsBeforeDelete(finalCleanup);
 }
 
-void StaticTransport::BuildUpdate(UpdateDataMapType& data_map, UpdatePlayerSet&)
+void StaticTransport::BuildUpdate(UpdateDataArena& data_map)
 {
     Map::PlayerList const& players = GetMap()->GetPlayers();
     if (players.isEmpty())
@@ -3223,17 +3223,8 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
    return value;
 }
 
-void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+uint32 Unit::GetValuesUpdateVisibleFlag(Player const* target) const
 {
-    if (!target)
-        return;
-
-    ByteBuffer fieldBuffer;
-
-    UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
-
-    uint32* flags = UnitUpdateFieldFlags;
     uint32 visibleFlag = UF_FLAG_PUBLIC;
 
     if (target == this)
@@ -3250,14 +3241,184 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
     if (plr && plr->IsInSameRaidWith(target))
         visibleFlag |= UF_FLAG_PARTY_MEMBER;
 
+    return visibleFlag;
+}
+
+bool Unit::IsValuesUpdateFieldSent(uint8 updateType, uint16 index, uint32 visibleFlag) const
+{
+    uint32 const* flags = UnitUpdateFieldFlags;
+    return _fieldNotifyFlags & flags[index]  //if the given flag was set to notify, if the given index is not set to UF_FLAG_NONE
+        || ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) //given index has UF_FLAG_SPECIAL_INFO and target has SPELL_AURA_EMPATHY on the target
+        || ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) // flag has changed && flag is visible to player
+        || (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK)); //if index UNIT_FIELD_AURASTATE && unit has some state (we always send update while the object has those)
+}
+
+// Fields sent with a different value depending on the target, see GetValuesUpdateFieldForTarget
+static uint16 const UnitTargetDependentFields[] =
+{
+    UNIT_NPC_FLAGS,
+    UNIT_FIELD_AURASTATE,
+    UNIT_FIELD_FLAGS,
+    UNIT_FIELD_DISPLAYID,
+    UNIT_DYNAMIC_FLAGS,
+#ifdef LICH_KING
+    UNIT_FIELD_BYTES_2,
+#endif
+    UNIT_FIELD_FACTIONTEMPLATE,
+};
+
+uint32 Unit::GetValuesUpdateFieldForTarget(uint16 index, Player* target) const
+{
     Creature const* creature = ToCreature();
+    switch (index)
+    {
+        case UNIT_NPC_FLAGS:
+        {
+            uint32 appendValue = m_uint32Values[UNIT_NPC_FLAGS];
+
+            if (creature)
+            {
+#ifdef LICH_KING
+                if (!target->CanSeeSpellClickOn(creature))
+                    appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+#endif
+                if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                {
+                    //sun: give quest marker precedence over flight master icon
+                    QuestGiverStatus questStatus = target->GetQuestDialogStatus(const_cast<Creature*>(creature));
+                    if (questStatus == DIALOG_STATUS_REWARD
+                        || questStatus == DIALOG_STATUS_AVAILABLE
+                        || questStatus == DIALOG_STATUS_REWARD) //any status missing?
+                        appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                }
+            }
+
+            return appendValue;
+        }
+        case UNIT_FIELD_AURASTATE:
+            // Check per caster aura states to not enable using a spell in client if specified aura is not by target
+            return BuildAuraStateUpdateForTarget(target);
+        // Gamemasters should be always able to select units - remove not selectable flag
+        case UNIT_FIELD_FLAGS:
+        {
+            uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
+            if (target->IsGameMaster())
+                appendValue &= ~UNIT_FLAG_NOT_SELECTABLE;
+
+            return appendValue;
+        }
+        // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
+        case UNIT_FIELD_DISPLAYID:
+        {
+            uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAYID];
+            if (creature)
+            {
+                CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
+
+                // this also applies for transform auras
+                if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(GetTransformSpell()))
+                    for (const auto & Effect : transform->Effects)
+                        if (Effect.ApplyAuraName == SPELL_AURA_TRANSFORM)
+                            if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(Effect.MiscValue))
+                            {
+                                cinfo = transformInfo;
+                                break;
+                            }
+
+                if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
+                    if (target->IsGameMaster())
+                        displayId = cinfo->GetFirstVisibleModel();
+            }
+
+            return displayId;
+        }
+        // hide lootable animation for unallowed players
+        case UNIT_DYNAMIC_FLAGS:
+        {
+            uint32 dynamicFlags = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+
+            if (creature)
+            {
+                if (creature->hasLootRecipient())
+                {
+                    dynamicFlags |= UNIT_DYNFLAG_TAPPED;
+                    if (creature->isTappedBy(target))
+                        dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                }
+
+                if (!target->IsAllowedToLoot(creature))
+                    dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
+            }
+
+            // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
+            if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
+                if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
+                    dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
+
+            return dynamicFlags;
+        }
+        // FG: pretend that OTHER players in own group are friendly ("blue")
+#ifdef LICH_KING
+        case UNIT_FIELD_BYTES_2: //UNIT_FIELD_BYTES_2 is not used for factions or pvp in BC
+#endif
+        case UNIT_FIELD_FACTIONTEMPLATE:
+        {
+            if (IsControlledByPlayer() && target != this && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
+            {
+                FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
+                FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
+                if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
+                {
+#ifdef LICH_KING
+                    if (index == UNIT_FIELD_BYTES_2)
+                        // Allow targetting opposite faction in party when enabled in config
+                        return (m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_UNK3) << 8)); // this flag is at uint8 offset 1 !!
+                    else
+#endif
+                        // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
+                        return uint32(target->GetFaction());
+                }
+            }
+
+            return m_uint32Values[index];
+        }
+        default:
+            return m_uint32Values[index];
+    }
+}
+
+bool Unit::GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const
+{
+    static_assert(std::extent<decltype(UnitTargetDependentFields)>::value <= std::tuple_size<decltype(key.targetValues)>::value, "ValuesUpdateViewerKey::targetValues too small");
+
+    key.visibleFlag = GetValuesUpdateVisibleFlag(target);
+
+    uint32 i = 0;
+    for (uint16 index : UnitTargetDependentFields)
+    {
+        if (IsValuesUpdateFieldSent(UPDATETYPE_VALUES, index, key.visibleFlag))
+            key.targetValues[i] = GetValuesUpdateFieldForTarget(index, target);
+        ++i;
+    }
+
+    return true;
+}
+
+void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target) const
+{
+    if (!target)
+        return;
+
+    ByteBuffer fieldBuffer;
+
+    UpdateMask updateMask;
+    updateMask.SetCount(m_valuesCount);
+
+    uint32 visibleFlag = GetValuesUpdateVisibleFlag(target);
+
     for (uint16 index = 0; index < m_valuesCount; ++index)
     {
-        if (   _fieldNotifyFlags & flags[index]  //if the given flag was set to notify, if the given index is not set to UF_FLAG_NONE
-            || ((flags[index] & visibleFlag) & UF_FLAG_SPECIAL_INFO) //given index has UF_FLAG_SPECIAL_INFO and target has SPELL_AURA_EMPATHY on the target
-            || ((updateType == UPDATETYPE_VALUES ? _changesMask.GetBit(index) : m_uint32Values[index]) && (flags[index] & visibleFlag)) // flag has changed && flag is visible to player
-            || (index == UNIT_FIELD_AURASTATE && HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK)) //if index UNIT_FIELD_AURASTATE && unit has some state (we always send update while the object has those)
-           )
+        if (IsValuesUpdateFieldSent(updateType, index, visibleFlag))
         {
             updateMask.SetBit(index);
 
@@ -3273,32 +3434,16 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
 
             } break;
             case UNIT_NPC_FLAGS:
-            {
-                uint32 appendValue = m_uint32Values[UNIT_NPC_FLAGS];
-
-                if (creature)
-                {
+            case UNIT_FIELD_AURASTATE:
+            case UNIT_FIELD_FLAGS:
+            case UNIT_FIELD_DISPLAYID:
+            case UNIT_DYNAMIC_FLAGS:
 #ifdef LICH_KING
-                    if (!target->CanSeeSpellClickOn(creature))
-                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+            case UNIT_FIELD_BYTES_2:
 #endif
-                    if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
-                    {
-                        //sun: give quest marker precedence over flight master icon
-                        QuestGiverStatus questStatus = target->GetQuestDialogStatus(const_cast<Creature*>(creature));
-                        if (questStatus == DIALOG_STATUS_REWARD
-                            || questStatus == DIALOG_STATUS_AVAILABLE
-                            || questStatus == DIALOG_STATUS_REWARD) //any status missing?
-                            appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                    }
-                }
-
-                fieldBuffer << uint32(appendValue);
-            } break;
-            case UNIT_FIELD_AURASTATE:
+            case UNIT_FIELD_FACTIONTEMPLATE:
             {
-                // Check per caster aura states to not enable using a spell in client if specified aura is not by target
-                fieldBuffer << BuildAuraStateUpdateForTarget(target);
+                fieldBuffer << GetValuesUpdateFieldForTarget(index, target);
             } break;
             // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
             case UNIT_FIELD_BASEATTACKTIME:
@@ -3336,92 +3481,6 @@ void Unit::BuildValuesUpdate(uint8 updateType, ByteBuffer* data, Player* target)
             {
                 fieldBuffer << uint32(m_floatValues[index]);
             } break;
-            // Gamemasters should be always able to select units - remove not selectable flag
-            case UNIT_FIELD_FLAGS:;
-            {
-                uint32 appendValue = m_uint32Values[UNIT_FIELD_FLAGS];
-                if (target->IsGameMaster())
-                    appendValue &= ~UNIT_FLAG_NOT_SELECTABLE;
-
-                fieldBuffer << uint32(appendValue);
-            } break;
-            // use modelid_a if not gm, _h if gm for CREATURE_FLAG_EXTRA_TRIGGER creatures
-            case UNIT_FIELD_DISPLAYID:
-            {
-                uint32 displayId = m_uint32Values[UNIT_FIELD_DISPLAYID];
-                if (creature)
-                {
-                    CreatureTemplate const* cinfo = creature->GetCreatureTemplate();
-
-                    // this also applies for transform auras
-                    if (SpellInfo const* transform = sSpellMgr->GetSpellInfo(GetTransformSpell()))
-                        for (const auto & Effect : transform->Effects)
-                            if (Effect.ApplyAuraName == SPELL_AURA_TRANSFORM)
-                                if (CreatureTemplate const* transformInfo = sObjectMgr->GetCreatureTemplate(Effect.MiscValue))
-                                {
-                                    cinfo = transformInfo;
-                                    break;
-                                }
-
-                    if (cinfo->flags_extra & CREATURE_FLAG_EXTRA_TRIGGER)
-                        if (target->IsGameMaster())
-                            displayId = cinfo->GetFirstVisibleModel();
-                }
-
-                fieldBuffer << uint32(displayId);
-            } break;
-            // hide lootable animation for unallowed players
-            case UNIT_DYNAMIC_FLAGS:
-            {
-                uint32 dynamicFlags = m_uint32Values[UNIT_DYNAMIC_FLAGS] & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-
-                if (creature)
-                {
-                    if (creature->hasLootRecipient())
-                    {
-                        dynamicFlags |= UNIT_DYNFLAG_TAPPED;
-                        if (creature->isTappedBy(target))
-                            dynamicFlags |= UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                    }
-
-                    if (!target->IsAllowedToLoot(creature))
-                        dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
-                }
-
-                // unit UNIT_DYNFLAG_TRACK_UNIT should only be sent to caster of SPELL_AURA_MOD_STALKED auras
-                if (dynamicFlags & UNIT_DYNFLAG_TRACK_UNIT)
-                    if (!HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetGUID()))
-                        dynamicFlags &= ~UNIT_DYNFLAG_TRACK_UNIT;
-
-                fieldBuffer << dynamicFlags;
-            } break;
-            // FG: pretend that OTHER players in own group are friendly ("blue")
-#ifdef LICH_KING
-            case UNIT_FIELD_BYTES_2: //UNIT_FIELD_BYTES_2 is not used for factions or pvp in BC
-#endif
-            case UNIT_FIELD_FACTIONTEMPLATE:
-            {
-                if (IsControlledByPlayer() && target != this && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP) && IsInRaidWith(target))
-                {
-                    FactionTemplateEntry const* ft1 = GetFactionTemplateEntry();
-                    FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
-                    if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
-                    {
-#ifdef LICH_KING
-                        if (index == UNIT_FIELD_BYTES_2)
-                            // Allow targetting opposite faction in party when enabled in config
-                            fieldBuffer << (m_uint32Values[UNIT_FIELD_BYTES_2] & ((UNIT_BYTE2_FLAG_UNK3) << 8)); // this flag is at uint8 offset 1 !!
-                        else
-#endif
-                            // pretend that all other HOSTILE players have own faction, to allow follow, heal, rezz (trade wont work)
-                            fieldBuffer << uint32(target->GetFaction());
-                    }
-                    else
-                        fieldBuffer << m_uint32Values[index];
-                }
-                else
-                    fieldBuffer << m_uint32Values[index];
-            } break;
             default:
             {
                 // send in current format (float as float, uint32 as uint32)
@@ -1953,10 +1953,16 @@ class TC_GAME_API Unit : public WorldObject
         bool IsFeighDeathDetected(Unit const* by) const;
         void ResetFeignDeathDetected();
 
+        bool GetValuesUpdateViewerKey(Player* target, ValuesUpdateViewerKey& key) const override;
+
     protected:
         explicit Unit (bool isWorldObject);
 
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, Player* target) const override;
+        uint32 GetValuesUpdateVisibleFlag(Player const* target) const;
+        bool IsValuesUpdateFieldSent(uint8 updateType, uint16 index, uint32 visibleFlag) const;
+        // Value sent to target for given field, for fields whose value depends on the target
+        uint32 GetValuesUpdateFieldForTarget(uint16 index, Player* target) const;
 
         bool _last_in_water_status;
         Position _lastInWaterCheckPosition;
@@ -37,6 +37,7 @@
 #include "GuildMgr.h"
 #include "ReputationMgr.h"
 #include "PoolMgr.h"
+#include "WorldDatabaseSnapshot.h"
 
 ScriptMapMap sQuestEndScripts;
 ScriptMapMap sQuestStartScripts;
@@ -279,7 +280,7 @@ void ObjectMgr::LoadCreatureTemplates(bool reload /* = false */)
 
     uint32 const expansion = sWorld->GetWowPatch() > WOW_PATCH_240 ? 2 : 1;
     //                                                 
-    QueryResult result = WorldDatabase.PQuery("SELECT entry, difficulty_entry_1, modelid1, modelid2, modelid3, "
+    QueryResult result = sWorldDatabaseSnapshot->PQuery("SELECT entry, difficulty_entry_1, modelid1, modelid2, modelid3, "
                                              //   5
                                              "modelid4, name, subname, IconName, gossip_menu_id, ct.minlevel, ct.maxlevel, exp, faction, npcflag, speed_walk, speed_run, "
                                              //
@@ -1234,24 +1235,9 @@ void ObjectMgr::LoadCreatures()
     _creatureDataStore.clear();
 
     uint32 count = 0;
-    //                                                0                1    2          3
-    QueryResult result = WorldDatabase.PQuery("SELECT creature.spawnID, map, spawnMask, modelid, "
-        //   4           5           6           7            8                9               10            11
-        "position_x, position_y, position_z, orientation, spawntimesecs, spawntimesecs_max, spawndist, currentwaypoint, "
-        //   12        13         14          15                 16          17      18         19         20         21
-        "curhealth, curmana, MovementType, unit_flags, creature.ScriptName, event, pool_id, pool_entry, patch_min, patch_max "
-        "FROM creature "
-        "LEFT OUTER JOIN game_event_creature ON creature.SpawnID = game_event_creature.guid "
-        "LEFT OUTER JOIN pool_creature ON creature.SpawnID = pool_creature.guid "
-        );
 
-    if(!result)
-    {
-        TC_LOG_ERROR("server.loading",">> Loaded 0 creature. DB table `creature` is empty.");
-        return;
-    }
-
-    QueryResult result2 = WorldDatabase.Query("SELECT spawnID, entry, equipment_id FROM creature_entry");
+    // both results are streamed, creature_entry rows must all be read before querying creature
+    QueryResult result2 = sWorldDatabaseSnapshot->StreamQuery("SELECT spawnID, entry, equipment_id FROM creature_entry");
     if (!result2)
     {
         TC_LOG_ERROR("server.loading", ">> Loaded 0 creature entries. DB table `creature_entry` is empty.");
@@ -1295,6 +1281,23 @@ void ObjectMgr::LoadCreatures()
         data.emplace_back(templateId, equipmentId);
     } while (result2->NextRow());
 
+    //                                                      0                1    2          3
+    QueryResult result = sWorldDatabaseSnapshot->PStreamQuery("SELECT creature.spawnID, map, spawnMask, modelid, "
+        //   4           5           6           7            8                9               10            11
+        "position_x, position_y, position_z, orientation, spawntimesecs, spawntimesecs_max, spawndist, currentwaypoint, "
+        //   12        13         14          15                 16          17      18         19         20         21
+        "curhealth, curmana, MovementType, unit_flags, creature.ScriptName, event, pool_id, pool_entry, patch_min, patch_max "
+        "FROM creature "
+        "LEFT OUTER JOIN game_event_creature ON creature.SpawnID = game_event_creature.guid "
+        "LEFT OUTER JOIN pool_creature ON creature.SpawnID = pool_creature.guid "
+        );
+
+    if(!result)
+    {
+        TC_LOG_ERROR("server.loading",">> Loaded 0 creature. DB table `creature` is empty.");
+        return;
+    }
+
     do
     {
         Field* fields = result->Fetch();
@@ -1465,8 +1468,9 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 count = 0;
 
-    //                                                0                1   2    3           4           5           6
-    QueryResult result = WorldDatabase.Query("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation,"
+    // no query is done until all rows are read
+    //                                                      0                1   2    3           4           5           6
+    QueryResult result = sWorldDatabaseSnapshot->StreamQuery("SELECT gameobject.guid, id, map, position_x, position_y, position_z, orientation,"
     //   7          8          9          10         11             12            13     14         15         16         17       18         19
         "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, event, ScriptName, pool_entry, patch_min, patch_max "
         "FROM gameobject "
@@ -1980,7 +1984,7 @@ void ObjectMgr::LoadItemTemplates()
     uint32 oldMSTime = GetMSTime();
 
     //                                                 0      1       2               3              4        5        6       7       8            9        10        11
-    QueryResult result = WorldDatabase.PQuery("SELECT entry, class, subclass, SoundOverrideSubclass, name, displayid, Quality, Flags, BuyCount, BuyPrice, SellPrice, InventoryType, "
+    QueryResult result = sWorldDatabaseSnapshot->PQuery("SELECT entry, class, subclass, SoundOverrideSubclass, name, displayid, Quality, Flags, BuyCount, BuyPrice, SellPrice, InventoryType, "
     //                                              12                                                                                                        19
                                              "AllowableClass, AllowableRace, ItemLevel, RequiredLevel, RequiredSkill, RequiredSkillRank, requiredspell, requiredhonorrank, "
     //                                              20
@@ -6187,7 +6191,7 @@ void ObjectMgr::LoadGameObjectTemplate()
     uint32 oldMSTime = GetMSTime();
 
     //                                                 0      1      2        3          4            5       6      7      8    9      10     11     12            14             16            18              20 
-    QueryResult result = WorldDatabase.PQuery("SELECT entry, type, displayId, name, castBarCaption, faction, flags, size, data0, data1, data2, data3, data4, data5, data6, data7, data8, data9, data10, data11, data12, "
+    QueryResult result = sWorldDatabaseSnapshot->PQuery("SELECT entry, type, displayId, name, castBarCaption, faction, flags, size, data0, data1, data2, data3, data4, data5, data6, data7, data8, data9, data10, data11, data12, "
     //                                          21               23             25              27                      30              32        33       34
                                              "data13, data14, data15, data16, data17, data18, data19, data20, data21, data22, data23, AIName, ScriptName, patch "
     //
@@ -8112,8 +8116,8 @@ void ObjectMgr::LoadSpellTemplates()
 
     std::string request = select_fields_str + std::string(" FROM spell_template ORDER BY entry");
     std::string request_override = select_fields_str + std::string(", customAttributesFlags FROM spell_template_override ORDER BY entry");
-    QueryResult result = WorldDatabase.Query(request.c_str());
-    QueryResult result_override = WorldDatabase.Query(request_override.c_str());
+    QueryResult result = sWorldDatabaseSnapshot->Query(request.c_str());
+    QueryResult result_override = sWorldDatabaseSnapshot->Query(request_override.c_str());
     if (!result) 
     {
         TC_LOG_ERROR("server.loading", "Table spell_template loading failed");
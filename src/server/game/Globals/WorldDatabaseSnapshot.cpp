@@ -0,0 +1,420 @@
+#include "WorldDatabaseSnapshot.h"
+#include "DatabaseEnv.h"
+#include "Field.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include "QueryResult.h"
+#include "SHA1.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    // Every table read by the queries going through the snapshot. A change in any of them invalidates the whole snapshot.
+    char const* const SNAPSHOT_TABLES[] =
+    {
+        "creature_template", "creature_template_movement", "creature_difficulty_flags",
+        "creature", "creature_entry", "game_event_creature", "pool_creature",
+        "gameobject_template", "gameobject", "game_event_gameobject", "pool_gameobject",
+        "item_template",
+        "spell_template", "spell_template_override",
+        "creature_loot_template", "disenchant_loot_template", "fishing_loot_template", "gameobject_loot_template",
+        "item_loot_template", "mail_loot_template", "pickpocketing_loot_template", "prospecting_loot_template",
+        "reference_loot_template", "skinning_loot_template",
+        "conditions",
+    };
+    size_t const SNAPSHOT_TABLES_COUNT = sizeof(SNAPSHOT_TABLES) / sizeof(SNAPSHOT_TABLES[0]);
+
+    char const SNAPSHOT_MAGIC[8] = { 'W', 'D', 'B', 'S', 'N', 'A', 'P', '\0' };
+    uint32 const SNAPSHOT_VERSION = 1;
+
+    /* File layout, native byte order:
+    - header
+    - payload, covered by header digest:
+      - for each table in SNAPSHOT_TABLES: name, checksum
+      - for each query: sql, fieldCount, rowCount, rowsSize, field types, rows (as serialized by ResultSet::AppendRow)
+    Strings are stored as their uint32 length followed by their characters. */
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32 version;
+        uint32 tableCount;
+        uint32 queryCount;
+        uint8 digest[SHA_DIGEST_LENGTH];
+        uint64 payloadSize;
+    };
+
+    // SHA1Hash takes int lengths
+    size_t const HASH_CHUNK_SIZE = 1 << 30;
+
+    void HashData(SHA1Hash& hash, uint8 const* data, size_t size)
+    {
+        for (size_t offset = 0; offset < size; offset += HASH_CHUNK_SIZE)
+            hash.UpdateData(data + offset, int(std::min(HASH_CHUNK_SIZE, size - offset)));
+    }
+
+    class SnapshotReader
+    {
+    public:
+        SnapshotReader(uint8 const* data, size_t size) : _position(data), _end(data + size) { }
+
+        template<class T>
+        bool Read(T& value)
+        {
+            if (Remaining() < sizeof(T))
+                return false;
+
+            memcpy(&value, _position, sizeof(T));
+            _position += sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& value)
+        {
+            uint32 length;
+            uint8 const* data;
+            if (!Read(length) || !(data = Skip(length)))
+                return false;
+
+            value.assign(reinterpret_cast<char const*>(data), length);
+            return true;
+        }
+
+        // Return pointer to the next size bytes, nullptr if there isn't enough data left
+        uint8 const* Skip(size_t size)
+        {
+            if (Remaining() < size)
+                return nullptr;
+
+            uint8 const* data = _position;
+            _position += size;
+            return data;
+        }
+
+        size_t Remaining() const { return size_t(_end - _position); }
+
+    private:
+        uint8 const* _position;
+        uint8 const* _end;
+    };
+
+    class SnapshotWriter
+    {
+    public:
+        explicit SnapshotWriter(FILE* file) : _file(file), _size(0), _failed(false)
+        {
+            _hash.Initialize();
+        }
+
+        void Write(uint8 const* data, size_t size)
+        {
+            if (!size)
+                return;
+
+            HashData(_hash, data, size);
+            if (fwrite(data, 1, size, _file) != size)
+                _failed = true;
+
+            _size += size;
+        }
+
+        template<class T>
+        void WriteValue(T const& value)
+        {
+            Write(reinterpret_cast<uint8 const*>(&value), sizeof(T));
+        }
+
+        void WriteString(std::string const& value)
+        {
+            WriteValue(uint32(value.size()));
+            Write(reinterpret_cast<uint8 const*>(value.data()), value.size());
+        }
+
+        void Finalize(uint8* digest)
+        {
+            _hash.Finalize();
+            memcpy(digest, _hash.GetDigest(), SHA_DIGEST_LENGTH);
+        }
+
+        uint64 GetSize() const { return _size; }
+        bool HasFailed() const { return _failed; }
+
+    private:
+        FILE* _file;
+        SHA1Hash _hash;
+        uint64 _size;
+        bool _failed;
+    };
+}
+
+WorldDatabaseSnapshot* WorldDatabaseSnapshot::instance()
+{
+    static WorldDatabaseSnapshot instance;
+    return &instance;
+}
+
+void WorldDatabaseSnapshot::Open(std::string const& path)
+{
+    uint32 oldMSTime = GetMSTime();
+
+    _checksums.clear();
+    if (!ComputeChecksums(_checksums))
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot: Could not checksum snapshot tables, world database snapshot is disabled.");
+        return;
+    }
+
+    _path = path;
+
+    std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+    if (file && Load(file))
+    {
+        TC_LOG_INFO("server.loading", ">> Loaded world database snapshot with %u queries in %u ms", uint32(_entries.size()), GetMSTimeDiffToNow(oldMSTime));
+        return;
+    }
+
+    _entries.clear();
+    TC_LOG_INFO("server.loading", ">> World database snapshot %s is missing or outdated, it will be written once loading is done", path.c_str());
+}
+
+bool WorldDatabaseSnapshot::ComputeChecksums(std::vector<uint64>& checksums)
+{
+    std::string sql = "CHECKSUM TABLE ";
+    for (size_t i = 0; i < SNAPSHOT_TABLES_COUNT; ++i)
+    {
+        if (i)
+            sql += ", ";
+
+        sql += "`";
+        sql += SNAPSHOT_TABLES[i];
+        sql += "`";
+    }
+
+    QueryResult result = WorldDatabase.Query(sql.c_str());
+    if (!result || result->GetRowCount() != SNAPSHOT_TABLES_COUNT)
+        return false;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        // checksum is NULL for missing tables
+        if (fields[1].IsNull())
+        {
+            TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot: Table %s does not exist.", fields[0].GetCString());
+            return false;
+        }
+
+        checksums.push_back(fields[1].GetUInt64());
+    } while (result->NextRow());
+
+    return true;
+}
+
+bool WorldDatabaseSnapshot::Load(std::shared_ptr<MappedFile> const& file)
+{
+    SnapshotReader reader(file->GetData(), file->GetSize());
+
+    SnapshotHeader header;
+    if (!reader.Read(header)
+        || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic))
+        || header.version != SNAPSHOT_VERSION
+        || header.payloadSize != reader.Remaining()
+        || header.tableCount != SNAPSHOT_TABLES_COUNT)
+        return false;
+
+    SHA1Hash hash;
+    hash.Initialize();
+    HashData(hash, file->GetData() + sizeof(header), reader.Remaining());
+    hash.Finalize();
+    if (memcmp(hash.GetDigest(), header.digest, SHA_DIGEST_LENGTH))
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot: %s is corrupted.", _path.c_str());
+        return false;
+    }
+
+    for (size_t i = 0; i < SNAPSHOT_TABLES_COUNT; ++i)
+    {
+        std::string table;
+        uint64 checksum;
+        if (!reader.ReadString(table) || !reader.Read(checksum) || table != SNAPSHOT_TABLES[i])
+            return false;
+
+        if (checksum != _checksums[i])
+        {
+            TC_LOG_INFO("server.loading", "WorldDatabaseSnapshot: Table `%s` changed since snapshot was written.", SNAPSHOT_TABLES[i]);
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < header.queryCount; ++i)
+    {
+        std::string sql;
+        uint32 fieldCount;
+        uint64 rowsSize;
+        Entry entry;
+        uint8 const* types;
+        if (!reader.ReadString(sql)
+            || !reader.Read(fieldCount)
+            || !reader.Read(entry.rowCount)
+            || !reader.Read(rowsSize)
+            || !(types = reader.Skip(fieldCount))
+            || !(entry.rows = reader.Skip(rowsSize)))
+            return false;
+
+        entry.size = size_t(rowsSize);
+
+        for (uint32 j = 0; j < fieldCount; ++j)
+            entry.types.push_back(DatabaseFieldTypes(types[j]));
+
+        entry.owner = file;
+        _entries[sql] = std::move(entry);
+    }
+
+    return !reader.Remaining();
+}
+
+void WorldDatabaseSnapshot::Close()
+{
+    if (!IsOpen())
+        return;
+
+    if (_recorded)
+        Save();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _entries.clear();
+    _checksums.clear();
+    _recorded = false;
+    _path.clear();
+}
+
+void WorldDatabaseSnapshot::Save() const
+{
+    uint32 oldMSTime = GetMSTime();
+
+    std::string const tempPath = _path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot: Could not open %s for writing.", tempPath.c_str());
+        return;
+    }
+
+    // written again once the payload digest is known
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    SnapshotWriter writer(file);
+    for (size_t i = 0; i < SNAPSHOT_TABLES_COUNT; ++i)
+    {
+        writer.WriteString(SNAPSHOT_TABLES[i]);
+        writer.WriteValue(_checksums[i]);
+    }
+
+    // queries not done during this loading are dropped
+    uint32 queryCount = 0;
+    for (auto const& pair : _entries)
+    {
+        Entry const& entry = pair.second;
+        if (!entry.used)
+            continue;
+
+        writer.WriteString(pair.first);
+        writer.WriteValue(uint32(entry.types.size()));
+        writer.WriteValue(entry.rowCount);
+        writer.WriteValue(uint64(entry.size));
+        for (DatabaseFieldTypes type : entry.types)
+            writer.WriteValue(uint8(type));
+        writer.Write(entry.rows, entry.size);
+        ++queryCount;
+    }
+
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.tableCount = uint32(SNAPSHOT_TABLES_COUNT);
+    header.queryCount = queryCount;
+    header.payloadSize = writer.GetSize();
+    writer.Finalize(header.digest);
+
+    written = written && !writer.HasFailed() && !fseek(file, 0, SEEK_SET) && fwrite(&header, sizeof(header), 1, file) == 1;
+    written = !fclose(file) && written;
+
+    // replace previous snapshot only once the new one is complete
+    if (!written || (std::remove(_path.c_str()) && errno != ENOENT) || std::rename(tempPath.c_str(), _path.c_str()))
+    {
+        TC_LOG_ERROR("server.loading", "WorldDatabaseSnapshot: Could not write %s.", _path.c_str());
+        std::remove(tempPath.c_str());
+        return;
+    }
+
+    TC_LOG_INFO("server.loading", ">> Saved world database snapshot with %u queries in %u ms", queryCount, GetMSTimeDiffToNow(oldMSTime));
+}
+
+QueryResult WorldDatabaseSnapshot::Query(char const* sql)
+{
+    if (!IsOpen())
+        return WorldDatabase.Query(sql);
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto itr = _entries.find(sql);
+        if (itr != _entries.end())
+        {
+            itr->second.used = true;
+            return MakeResult(itr->second);
+        }
+    }
+
+    // not in snapshot yet, query the database and record the result. Rows are streamed so that they are only stored once, in the recording.
+    QueryResult result = WorldDatabase.StreamQuery(sql);
+
+    std::shared_ptr<std::vector<uint8>> rows = std::make_shared<std::vector<uint8>>();
+    Entry entry;
+    if (result)
+    {
+        for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+            entry.types.push_back(result->GetFieldType(i));
+
+        do
+        {
+            result->AppendRow(*rows);
+            ++entry.rowCount;
+        } while (result->NextRow());
+    }
+
+    entry.rows = rows->data();
+    entry.size = rows->size();
+    entry.owner = std::move(rows);
+    entry.used = true;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _recorded = true;
+    Entry& recorded = _entries[sql];
+    recorded = std::move(entry);
+    return MakeResult(recorded);
+}
+
+QueryResult WorldDatabaseSnapshot::StreamQuery(char const* sql)
+{
+    // an open snapshot already streams what it records
+    if (!IsOpen())
+        return WorldDatabase.StreamQuery(sql);
+
+    return Query(sql);
+}
+
+QueryResult WorldDatabaseSnapshot::MakeResult(Entry const& entry)
+{
+    if (!entry.rowCount)
+        return QueryResult(nullptr);
+
+    QueryResult result = std::make_shared<ResultSet>(entry.owner, entry.rows, entry.size, entry.rowCount, entry.types);
+    if (!result->NextRow())
+        return QueryResult(nullptr);
+
+    return result;
+}
@@ -0,0 +1,80 @@
+
+#ifndef _WORLD_DATABASE_SNAPSHOT_H_INCLUDED
+#define _WORLD_DATABASE_SNAPSHOT_H_INCLUDED
+
+#include "Define.h"
+#include "DatabaseEnvFwd.h"
+#include "StringFormat.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MappedFile;
+enum class DatabaseFieldTypes : uint8;
+
+/**
+On disk copy of the results of the biggest world database queries done at startup (templates, spawns, loot, conditions).
+- Open() maps the snapshot file and checks it against the current `CHECKSUM TABLE` of every table those queries read.
+  If anything changed (or there is no file yet), queries go to the database and their results are recorded instead.
+- Query() returns the snapshot rows for a query already in the snapshot, without involving MySQL at all.
+  Rows are read from the mapped file, fields are still converted by Field getters as with any ad hoc query.
+- StreamQuery() is the same, except that with the snapshot closed rows are read from the database while the result is iterated.
+  Only for loaders that do not query the world database until they are done with the result, see DatabaseWorkerPool::StreamQuery.
+- Close() writes a new snapshot file if anything was recorded, then all queries go to the database again (reloads...).
+Only queries reading tables listed in SNAPSHOT_TABLES (see .cpp) may go through here, else their changes would go unnoticed.
+*/
+class WorldDatabaseSnapshot
+{
+public:
+    static WorldDatabaseSnapshot* instance();
+
+    void Open(std::string const& path);
+    void Close();
+    bool IsOpen() const { return !_path.empty(); }
+
+    QueryResult Query(char const* sql);
+
+    template<typename Format, typename... Args>
+    QueryResult PQuery(Format&& sql, Args&&... args)
+    {
+        return Query(Trinity::StringFormat(std::forward<Format>(sql), std::forward<Args>(args)...).c_str());
+    }
+
+    QueryResult StreamQuery(char const* sql);
+
+    template<typename Format, typename... Args>
+    QueryResult PStreamQuery(Format&& sql, Args&&... args)
+    {
+        return StreamQuery(Trinity::StringFormat(std::forward<Format>(sql), std::forward<Args>(args)...).c_str());
+    }
+
+private:
+    WorldDatabaseSnapshot() { }
+
+    struct Entry
+    {
+        std::shared_ptr<void const> owner; // mapped file or recorded rows buffer
+        uint8 const* rows = nullptr;
+        size_t size = 0;
+        uint64 rowCount = 0;
+        std::vector<DatabaseFieldTypes> types;
+        bool used = false;
+    };
+
+    static bool ComputeChecksums(std::vector<uint64>& checksums);
+    bool Load(std::shared_ptr<MappedFile> const& file);
+    void Save() const;
+    static QueryResult MakeResult(Entry const& entry);
+
+    std::string _path;
+    std::vector<uint64> _checksums;
+    bool _recorded = false;
+
+    std::mutex _lock;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+#define sWorldDatabaseSnapshot WorldDatabaseSnapshot::instance()
+
+#endif //_WORLD_DATABASE_SNAPSHOT_H_INCLUDED
@@ -6,6 +6,7 @@
 #include "DBCStores.h"
 #include "Management/VMapFactory.h"
 #include "Management/MMapManager.h"
+#include "MappedFile.h"
 
 u_map_magic MapMagic        = { {'M','A','P','S'} };
 u_map_magic MapVersionMagic = { {'v','1','.','8'} };
@@ -46,79 +47,71 @@ GridMap::GridMap()
     _holes = nullptr;
 }
 
-GridMap::~GridMap()
-{
-    unloadData();
-}
+GridMap::~GridMap() = default;
 
 bool GridMap::loadData(char* filename)
 {
     // Unload old data if exist
     unloadData();
 
-    map_fileheader header;
-    // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
-        return true;
-
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    bool exists;
+    std::shared_ptr<MappedFile> file = MappedFile::Open(filename, &exists);
+    if (!file)
     {
-        fclose(in);
+        // Not return error if file not found
+        if (!exists)
+            return true;
+
+        TC_LOG_ERROR("maps", "Map file '%s' is empty or could not be mapped.", filename);
         return false;
     }
 
-    if (header.mapMagic.asUInt == MapMagic.asUInt && header.versionMagic.asUInt == MapVersionMagic.asUInt)
+    map_fileheader const* header = file->GetArray<map_fileheader>(0);
+    if (!header)
+        return false;
+
+    if (header->mapMagic.asUInt == MapMagic.asUInt && header->versionMagic.asUInt == MapVersionMagic.asUInt)
     {
+        _file = std::move(file);
+
         // load up area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header->areaMapOffset && !loadAreaData(header->areaMapOffset, header->areaMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
         // load up height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header->heightMapOffset && !loadHeightData(header->heightMapOffset, header->heightMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
         // load up liquid data
-        if (header.liquidMapOffset && !loadLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header->liquidMapOffset && !loadLiquidData(header->liquidMapOffset, header->liquidMapSize))
         {
             TC_LOG_ERROR("maps", "Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
         // loadup holes data (if any. check header.holesOffset)
-        if (header.holesSize && !loadHolesData(in, header.holesOffset, header.holesSize))
+        if (header->holesSize && !loadHolesData(header->holesOffset, header->holesSize))
         {
             TC_LOG_ERROR("maps", "Error loading map holes data\n");
-        fclose(in);
+            unloadData();
             return false;
         }
-        fclose(in);
         return true;
     }
 
     TC_LOG_ERROR("maps", "Map file '%s' is from an incompatible map version (%.*s %.*s), %.*s %.*s is expected. Please recreate using the mapextractor.",
-        filename, 4, header.mapMagic.asChar, 4, header.versionMagic.asChar, 4, MapMagic.asChar, 4, MapVersionMagic.asChar);
-    fclose(in);
+        filename, 4, header->mapMagic.asChar, 4, header->versionMagic.asChar, 4, MapMagic.asChar, 4, MapVersionMagic.asChar);
     return false;
 }
 
 void GridMap::unloadData()
 {
-    delete[] _areaMap;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
-    delete[] _holes;
-    delete[] _minHeight;
-    delete[] _maxHeight;
     _areaMap = nullptr;
     m_V9 = nullptr;
     m_V8 = nullptr;
@@ -129,64 +122,90 @@ void GridMap::unloadData()
     _liquidMap  = nullptr;
     _holes = nullptr;
     _gridGetHeight = &GridMap::getHeightFromFlat;
+    _copiedData.clear();
+    _file.reset();
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<class T>
+bool GridMap::mapArray(T const*& dest, uint32 offset, uint32 count)
+{
+    T const* src = _file->GetArray<T>(offset, count);
+    if (!src)
+        return false;
+
+    if (reinterpret_cast<uintptr_t>(src) % alignof(T) == 0)
+    {
+        dest = src;
+        return true;
+    }
+
+    // misaligned in file, can't use it in place
+    std::unique_ptr<T[]> copy(new T[count]);
+    memcpy(copy.get(), src, count * sizeof(T));
+    dest = copy.get();
+    _copiedData.emplace_back(copy.release(), [](void* data) { delete[] static_cast<T*>(data); });
+    return true;
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
 {
     map_areaHeader header;
-    fseek(in, offset, SEEK_SET);
+    map_areaHeader const* fileHeader = _file->GetArray<map_areaHeader>(offset);
+    if (!fileHeader)
+        return false;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapAreaMagic.asUInt)
+    memcpy(&header, fileHeader, sizeof(header));
+    if (header.fourcc != MapAreaMagic.asUInt)
         return false;
 
     _gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
-    {
-        _areaMap = new uint16 [16*16];
-        if (fread(_areaMap, sizeof(uint16), 16*16, in) != 16*16)
+        if (!mapArray(_areaMap, offset + sizeof(header), 16*16))
             return false;
-    }
+
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     map_heightHeader header;
-    fseek(in, offset, SEEK_SET);
+    map_heightHeader const* fileHeader = _file->GetArray<map_heightHeader>(offset);
+    if (!fileHeader)
+        return false;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapHeightMagic.asUInt)
+    memcpy(&header, fileHeader, sizeof(header));
+    if (header.fourcc != MapHeightMagic.asUInt)
         return false;
 
+    offset += sizeof(header);
+
     _gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129*129];
-            m_uint16_V8 = new uint16 [128*128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129*129, in) != 129*129 ||
-                fread(m_uint16_V8, sizeof(uint16), 128*128, in) != 128*128)
+            if (!mapArray(m_uint16_V9, offset, 129*129) ||
+                !mapArray(m_uint16_V8, offset + 129*129*sizeof(uint16), 128*128))
                 return false;
+            offset += (129*129 + 128*128) * sizeof(uint16);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             _gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129*129];
-            m_uint8_V8 = new uint8 [128*128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129*129, in) != 129*129 ||
-                fread(m_uint8_V8, sizeof(uint8), 128*128, in) != 128*128)
+            if (!mapArray(m_uint8_V9, offset, 129*129) ||
+                !mapArray(m_uint8_V8, offset + 129*129*sizeof(uint8), 128*128))
                 return false;
+            offset += (129*129 + 128*128) * sizeof(uint8);
             _gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             _gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129*129];
-            m_V8 = new float [128*128];
-            if (fread(m_V9, sizeof(float), 129*129, in) != 129*129 ||
-                fread(m_V8, sizeof(float), 128*128, in) != 128*128)
+            if (!mapArray(m_V9, offset, 129*129) ||
+                !mapArray(m_V8, offset + 129*129*sizeof(float), 128*128))
                 return false;
+            offset += (129*129 + 128*128) * sizeof(float);
             _gridGetHeight = &GridMap::getHeightFromFloat;
         }
     }
@@ -196,24 +215,27 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (header.flags & MAP_HEIGHT_HAS_FLIGHT_BOUNDS)
     {
-        _maxHeight = new int16[3 * 3];
-        _minHeight = new int16[3 * 3];
-        if (fread(_maxHeight, sizeof(int16), 3 * 3, in) != 3 * 3 ||
-            fread(_minHeight, sizeof(int16), 3 * 3, in) != 3 * 3)
+        if (!mapArray(_maxHeight, offset, 3 * 3) ||
+            !mapArray(_minHeight, offset + 3 * 3 * sizeof(int16), 3 * 3))
             return false;
     }
 
     return true;
 }
 
-bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadLiquidData(uint32 offset, uint32 /*size*/)
 {
     map_liquidHeader header;
-    fseek(in, offset, SEEK_SET);
+    map_liquidHeader const* fileHeader = _file->GetArray<map_liquidHeader>(offset);
+    if (!fileHeader)
+        return false;
 
-    if (fread(&header, sizeof(header), 1, in) != 1 || header.fourcc != MapLiquidMagic.asUInt)
+    memcpy(&header, fileHeader, sizeof(header));
+    if (header.fourcc != MapLiquidMagic.asUInt)
         return false;
 
+    offset += sizeof(header);
+
     _liquidType   = header.liquidType;
     _liquidOffX  = header.offsetX;
     _liquidOffY  = header.offsetY;
@@ -223,33 +245,25 @@ bool GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        _liquidEntry = new uint16[16*16];
-        if (fread(_liquidEntry, sizeof(uint16), 16*16, in) != 16*16)
+        if (!mapArray(_liquidEntry, offset, 16*16))
             return false;
 
-        _liquidFlags = new uint8[16*16];
-        if (fread(_liquidFlags, sizeof(uint8), 16*16, in) != 16*16)
+        if (!mapArray(_liquidFlags, offset + 16*16*sizeof(uint16), 16*16))
             return false;
+
+        offset += 16*16 * (sizeof(uint16) + sizeof(uint8));
     }
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        _liquidMap = new float[uint32(_liquidWidth) * uint32(_liquidHeight)];
-        if (fread(_liquidMap, sizeof(float), _liquidWidth*_liquidHeight, in) != (uint32(_liquidWidth) * uint32(_liquidHeight)))
+        if (!mapArray(_liquidMap, offset, uint32(_liquidWidth) * uint32(_liquidHeight)))
             return false;
     }
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 size)
+bool GridMap::loadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-
-    _holes = new uint16[16 * 16];
-    if (fread(_holes, sizeof(uint16), 16 * 16, in) != 16 * 16)
-        return false;
-
-    return true;
+    return mapArray(_holes, offset, 16 * 16);
 }
 
 uint16 GridMap::getArea(float x, float y) const
@@ -373,7 +387,7 @@ float GridMap::getHeightFromUint8(float x, float y, bool walkableOnly) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint8 *V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -443,7 +457,7 @@ float GridMap::getHeightFromUint16(float x, float y, bool walkableOnly) const
         return INVALID_HEIGHT;
 
     int32 a, b, c;
-    uint16 *V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int*128 + x_int + y_int];
     if (x+y < 1)
     {
         if (x > y)
@@ -4,6 +4,10 @@
 #include "Define.h"
 #include "GridDefines.h"
 #include "WaterDefines.h"
+#include <memory>
+#include <vector>
+
+class MappedFile;
 
 
 // ******************************************
@@ -62,31 +66,36 @@ struct map_liquidHeader
 class TC_GAME_API GridMap
 {
     uint32  _flags;
+    // Data arrays point directly into the memory mapped .map file. Pages are shared with every other GridMap using the same file.
+    std::shared_ptr<MappedFile> _file;
+    // arrays that could not be used in place in the file because of alignment
+    std::vector<std::shared_ptr<void>> _copiedData;
+
     union{
-        float* m_V9;
-        uint16* m_uint16_V9;
-        uint8* m_uint8_V9;
+        float const* m_V9;
+        uint16 const* m_uint16_V9;
+        uint8 const* m_uint8_V9;
     };
     union{
-        float* m_V8;
-        uint16* m_uint16_V8;
-        uint8* m_uint8_V8;
+        float const* m_V8;
+        uint16 const* m_uint16_V8;
+        uint8 const* m_uint8_V8;
     };
-    int16* _maxHeight;
-    int16* _minHeight;
+    int16 const* _maxHeight;
+    int16 const* _minHeight;
 
     // Height level data
     float _gridHeight;
     float _gridIntHeightMultiplier;
 
     // Area data
-    uint16* _areaMap;
+    uint16 const* _areaMap;
 
     // Liquid data
     float _liquidLevel;
-    uint16* _liquidEntry; //liquid entry for chunk ?
-    uint8* _liquidFlags;
-    float* _liquidMap;
+    uint16 const* _liquidEntry; //liquid entry for chunk ?
+    uint8 const* _liquidFlags;
+    float const* _liquidMap;
     uint16 _gridArea;
     uint16 _liquidType; //default liquid type for map?
     uint8 _liquidOffX;
@@ -94,12 +103,15 @@ class TC_GAME_API GridMap
     uint8 _liquidWidth;
     uint8 _liquidHeight;
 
-    uint16* _holes;
+    uint16 const* _holes;
 
-    bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-    bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-    bool loadLiquidData(FILE* in, uint32 offset, uint32 size);
-    bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+    // point dest to count T's at offset in file
+    template<class T>
+    bool mapArray(T const*& dest, uint32 offset, uint32 count);
+    bool loadAreaData(uint32 offset, uint32 size);
+    bool loadHeightData(uint32 offset, uint32 size);
+    bool loadLiquidData(uint32 offset, uint32 size);
+    bool loadHolesData(uint32 offset, uint32 size);
     bool isHole(int row, int col) const;
 
     // Get height functions and pointers. walkableOnly NYI
@@ -102,6 +102,7 @@ namespace Trinity
 	{
 		WorldObject const* i_source;
 		WorldPacket const* i_message;
+		SharedWorldPacket i_sharedMessage;
 		uint32 i_phaseMask;
 		float i_distSq;
 		Team team;
@@ -129,7 +130,14 @@ namespace Trinity
 			if (!player->HaveAtClient(i_source))
 				return;
 
-			player->GetSession()->SendPacket(i_message);
+			if (player->GetSession()->IsPacketIgnored(i_message->GetOpcode()))
+				return;
+
+			// copy message only once, then queue it by reference for every receiver
+			if (!i_sharedMessage)
+				i_sharedMessage = std::make_shared<WorldPacket const>(*i_message);
+
+			player->GetSession()->SendPacket(i_sharedMessage);
 		}
 	};
 
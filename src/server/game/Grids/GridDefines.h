@@ -26,6 +26,10 @@ class Player;
 #define MIN_GRID_DELAY          (MINUTE*IN_MILLISECONDS)
 #define MIN_MAP_UPDATE_DELAY    50
 
+#define GRID_PREFETCH_INTERVAL  1000                        // ms between two looks for grids to load in background ahead of players, see Map::PrefetchGridsAhead
+#define GRID_PREFETCH_LOOKAHEAD 20000                       // load grids where moving players will be in this time (ms)
+#define GRID_PREFETCH_DISTANCE  (2*SIZE_OF_GRIDS)           // max distance beyond visibility range to look for grids to load
+
 #define MAX_NUMBER_OF_CELLS     8
 #define SIZE_OF_GRID_CELL       (SIZE_OF_GRIDS/MAX_NUMBER_OF_CELLS)
 
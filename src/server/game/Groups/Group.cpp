@@ -1838,14 +1838,15 @@ void Group::UpdatePlayerOutOfRange(Player* player)
 
 void Group::BroadcastPacket(WorldPacket *packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignoredPlayer)
 {
+    SharedWorldPacket sharedPacket = std::make_shared<WorldPacket const>(*packet);
     for(GroupReference *itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
         if(!player || (!ignoredPlayer.IsEmpty() && player->GetGUID() == ignoredPlayer) || (ignorePlayersInBGRaid && player->GetGroup() != this))
             continue;
 
-        if (player->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            player->SendDirectMessage(packet);
+        if (player->GetSession() && (group == -1 || itr->getSubGroup() == group) && !player->GetSession()->IsPacketIgnored(packet->GetOpcode()))
+            player->SendDirectMessage(sharedPacket);
     }
 }
 
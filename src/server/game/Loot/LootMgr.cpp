@@ -26,8 +26,12 @@
 #include "SharedDefines.h"
 #include "ItemEnchantmentMgr.h"
 #include "Loot.h"
+#include "WorldDatabaseSnapshot.h"
 #include <functional>
 
+// rows decoded at once when loading loot tables
+#define LOOT_LOAD_BLOCK_ROWS 4096
+
 static Rates const qualityToRate[MAX_ITEM_QUALITY] = {
     RATE_DROP_ITEM_POOR,                                    // ITEM_QUALITY_POOR
     RATE_DROP_ITEM_NORMAL,                                  // ITEM_QUALITY_NORMAL
@@ -133,54 +137,70 @@ uint32 LootStore::LoadLootTable()
     TC_LOG_INFO("server.loading", "%s :", GetName());
 
     //                                                 0     1     2          3       4              5         6        7         8        
-    QueryResult result = WorldDatabase.PQuery("SELECT Entry, Item, Reference, Chance, QuestRequired, LootMode, GroupId, MinCount, MaxCount "
+    // no query is done until all rows are read
+    QueryResult result = sWorldDatabaseSnapshot->PStreamQuery("SELECT Entry, Item, Reference, Chance, QuestRequired, LootMode, GroupId, MinCount, MaxCount "
                                               "FROM %s t1 WHERE ((%u >= patch_min) && (%u <= patch_max))", GetName(), sWorld->GetWowPatch(), sWorld->GetWowPatch());
 
     if(!result)
         return 0;
 
+    // all columns are numeric, decode them by blocks of rows rather than field by field
+    ResultColumns columns;
+    bool moreRows;
     do
     {
-        Field *fields = result->Fetch();
-
-        uint32 entry               = fields[0].GetUInt32();
-        uint32 item                = fields[1].GetUInt32();
-        uint32 reference           = fields[2].GetUInt32();
-        float  chance              = fields[3].GetFloat();
-        bool   needsquest          = fields[4].GetBool();
-        uint16 lootmode            = fields[5].GetUInt16();
-        uint8  groupid             = fields[6].GetUInt8();
-        uint8  mincount            = fields[7].GetUInt8();
-        uint8  maxcount            = fields[8].GetUInt8();
-
-        LootStoreItem* storeitem = new LootStoreItem(item, reference, chance, needsquest, lootmode, groupid, mincount, maxcount);
-
-        if (!storeitem->IsValid(*this, entry))            // Validity checks
-        {
-            delete storeitem;
-            continue;
-        }
-
-        // Looking for the template of the entry
-                                                        // often entries are put together
-        if (m_LootTemplates.empty() || tab->first != entry)
+        moreRows = result->FetchColumns(columns, LOOT_LOAD_BLOCK_ROWS);
+
+        std::vector<int64> const& entries       = columns.GetIntegers(0);
+        std::vector<int64> const& items         = columns.GetIntegers(1);
+        std::vector<int64> const& references    = columns.GetIntegers(2);
+        std::vector<double> const& chances      = columns.GetReals(3);
+        std::vector<int64> const& questRequired = columns.GetIntegers(4);
+        std::vector<int64> const& lootModes     = columns.GetIntegers(5);
+        std::vector<int64> const& groupIds      = columns.GetIntegers(6);
+        std::vector<int64> const& minCounts     = columns.GetIntegers(7);
+        std::vector<int64> const& maxCounts     = columns.GetIntegers(8);
+
+        for (uint32 row = 0; row < columns.GetRowCount(); ++row)
         {
-            // Searching the template (in case template Id changed)
-            tab = m_LootTemplates.find(entry);
-            if ( tab == m_LootTemplates.end() )
+            uint32 entry               = uint32(entries[row]);
+            uint32 item                = uint32(items[row]);
+            uint32 reference           = uint32(references[row]);
+            float  chance              = float(chances[row]);
+            bool   needsquest          = questRequired[row] == 1;
+            uint16 lootmode            = uint16(lootModes[row]);
+            uint8  groupid             = uint8(groupIds[row]);
+            uint8  mincount            = uint8(minCounts[row]);
+            uint8  maxcount            = uint8(maxCounts[row]);
+
+            LootStoreItem* storeitem = new LootStoreItem(item, reference, chance, needsquest, lootmode, groupid, mincount, maxcount);
+
+            if (!storeitem->IsValid(*this, entry))            // Validity checks
             {
-                std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
-                tab = pr.first;
+                delete storeitem;
+                continue;
             }
-        }
-        // else is empty - template Id and iter are the same
-        // finally iter refers to already existed or just created <entry, LootTemplate>
 
-        // Adds current row to the template
-        tab->second->AddEntry(storeitem);
-        ++count;
+            // Looking for the template of the entry
+                                                            // often entries are put together
+            if (m_LootTemplates.empty() || tab->first != entry)
+            {
+                // Searching the template (in case template Id changed)
+                tab = m_LootTemplates.find(entry);
+                if ( tab == m_LootTemplates.end() )
+                {
+                    std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
+                    tab = pr.first;
+                }
+            }
+            // else is empty - template Id and iter are the same
+            // finally iter refers to already existed or just created <entry, LootTemplate>
 
-    } while (result->NextRow());
+            // Adds current row to the template
+            tab->second->AddEntry(storeitem);
+            ++count;
+        }
+    } while (moreRows);
 
     Verify();                                           // Checks validity of the loot store
 
@@ -0,0 +1,138 @@
+#include "GridPrefetcher.h"
+#include "GridMap.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include "MapTree.h"
+#include "Management/MMapManager.h"
+#include "World.h"
+
+namespace
+{
+    // Touch every page of the file so that it gets into the file system cache
+    void WarmFile(std::string const& path)
+    {
+        std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+        if (!file)
+            return;
+
+        volatile uint8 sink = 0;
+        for (size_t offset = 0; offset < file->GetSize(); offset += 4096)
+            sink ^= file->GetData()[offset];
+    }
+}
+
+GridPrefetcher::GridPrefetcher() : _cancelationToken(false), _lastReadyStamp(0)
+{
+}
+
+GridPrefetcher::~GridPrefetcher()
+{
+    Stop();
+}
+
+void GridPrefetcher::Start(size_t num_threads)
+{
+    for (size_t i = 0; i < num_threads; ++i)
+        _threads.push_back(std::thread(&GridPrefetcher::WorkerThread, this));
+}
+
+void GridPrefetcher::Stop()
+{
+    if (_threads.empty())
+        return;
+
+    _cancelationToken = true;
+    _queue.Cancel();
+
+    for (auto& thread : _threads)
+        if (thread.joinable())
+            thread.join();
+
+    _threads.clear();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _pending.clear();
+    _ready.clear();
+}
+
+void GridPrefetcher::Prefetch(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsEnabled())
+        return;
+
+    uint32 const key = MakeKey(mapId, gx, gy);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_ready.count(key) || !_pending.insert(key).second)
+            return;
+    }
+
+    _queue.Push(key);
+}
+
+GridMap* GridPrefetcher::TakeGridMap(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsEnabled())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _ready.find(MakeKey(mapId, gx, gy));
+    if (itr == _ready.end())
+        return nullptr;
+
+    GridMap* gridMap = itr->second.gridMap.release();
+    _ready.erase(itr);
+    return gridMap;
+}
+
+void GridPrefetcher::WorkerThread()
+{
+    while (1)
+    {
+        uint32 key = 0;
+        _queue.WaitAndPop(key);
+
+        if (_cancelationToken)
+            return;
+
+        Load(key);
+    }
+}
+
+void GridPrefetcher::Load(uint32 key)
+{
+    uint32 const mapId = key >> 12;
+    uint32 const gx = (key >> 6) & 0x3F;
+    uint32 const gy = key & 0x3F;
+
+    std::string const mapFileName = Trinity::StringFormat("%smaps/%03u%02u%02u.map", sWorld->GetDataPath().c_str(), mapId, gx, gy);
+    std::unique_ptr<GridMap> gridMap = std::make_unique<GridMap>();
+    if (!gridMap->loadData(const_cast<char*>(mapFileName.c_str())))
+    {
+        // let the map thread load it again and log the error
+        TC_LOG_DEBUG("maps", "GridPrefetcher: failed to load map file %s", mapFileName.c_str());
+        gridMap.reset();
+    }
+
+    WarmFile(sWorld->GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, gx, gy));
+    WarmFile(MMAP::MMapManager::GetTileFileName(mapId, gx, gy));
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _pending.erase(key);
+    if (!gridMap)
+        return;
+
+    if (_ready.size() >= MAX_READY_GRIDMAPS)
+    {
+        auto oldest = _ready.begin();
+        for (auto itr = _ready.begin(); itr != _ready.end(); ++itr)
+            if (itr->second.stamp < oldest->second.stamp)
+                oldest = itr;
+
+        _ready.erase(oldest);
+    }
+
+    ReadyGridMap& ready = _ready[key];
+    ready.gridMap = std::move(gridMap);
+    ready.stamp = ++_lastReadyStamp;
+}
@@ -0,0 +1,63 @@
+
+#ifndef _GRID_PREFETCHER_H_INCLUDED
+#define _GRID_PREFETCHER_H_INCLUDED
+
+#include "Define.h"
+#include "ProducerConsumerQueue.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class GridMap;
+
+/**
+Loads grids terrain in background threads, ahead of players moving toward them (see Map::PrefetchGridsAhead):
+- .map files are loaded into GridMap's, handed over to Map::LoadMap when the grid gets created
+- vmap and mmap tiles files are read, so that loading them in the map thread only hits the file system cache
+Spawns are still loaded by the map thread when the grid gets created, creating objects needs the map.
+*/
+class GridPrefetcher
+{
+public:
+    GridPrefetcher();
+    ~GridPrefetcher();
+
+    void Start(size_t num_threads);
+    void Stop();
+    bool IsEnabled() const { return !_threads.empty(); }
+
+    // Queue loading of given grid (in GridMaps coordinates), if not already queued or loaded
+    void Prefetch(uint32 mapId, uint32 gx, uint32 gy);
+    // Take prefetched GridMap for given grid if any. Caller owns the returned GridMap.
+    GridMap* TakeGridMap(uint32 mapId, uint32 gx, uint32 gy);
+
+private:
+    // loaded GridMap's not taken yet, oldest are dropped past this count
+    static constexpr size_t MAX_READY_GRIDMAPS = 256;
+
+    struct ReadyGridMap
+    {
+        std::unique_ptr<GridMap> gridMap;
+        uint32 stamp; // load order, to find the oldest one
+    };
+
+    static uint32 MakeKey(uint32 mapId, uint32 gx, uint32 gy) { return (mapId << 12) | (gx << 6) | gy; }
+
+    void WorkerThread();
+    void Load(uint32 key);
+
+    std::vector<std::thread> _threads;
+    ProducerConsumerQueue<uint32> _queue;
+    std::atomic<bool> _cancelationToken;
+
+    std::mutex _lock;
+    std::unordered_set<uint32> _pending; // queued or being loaded
+    std::unordered_map<uint32, ReadyGridMap> _ready;
+    uint32 _lastReadyStamp;
+};
+
+#endif //_GRID_PREFETCHER_H_INCLUDED
@@ -38,11 +38,18 @@
 #include "ScriptMgr.h"
 #include "GameTime.h"
 #include "PathGenerator.h"
+#include "GridPrefetcher.h"
+#include "FlightPathMovementGenerator.h"
+#include "Tracing.h"
 #ifdef TESTS
 #include "TestCase.h"
 #include "TestThread.h"
 #include "TestPlayer.h"
 #endif
+#ifdef PLAYERBOT
+#include "playerbot.h"
+#include "PlayerbotThinkPool.h"
+#endif
 
 #include <unordered_set>
 #include <vector>
@@ -151,19 +158,30 @@ void Map::LoadMap(int gx, int gy, bool reload)
         GridMaps[gx][gy] = nullptr;
     }
 
-    // map file name
-    char *tmp = nullptr;
-    // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
-    int len = sWorld->GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
-    tmp = new char[len];
-    snprintf(tmp, len, (char *)(sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), GetId(), gx, gy);
-    TC_LOG_DEBUG("maps","Loading map %s",tmp);
-    // loading data
-    GridMaps[gx][gy] = new GridMap();
-    if (!GridMaps[gx][gy]->loadData(tmp))
-        TC_LOG_ERROR("maps","ERROR loading map file: \n %s\n", tmp);
+    // may have been loaded in background already
+    GridMaps[gx][gy] = sMapMgr->GetGridPrefetcher()->TakeGridMap(GetId(), gx, gy);
+    if (GridMaps[gx][gy] && reload)
+    {
+        delete GridMaps[gx][gy];
+        GridMaps[gx][gy] = nullptr;
+    }
 
-    delete [] tmp;
+    if (!GridMaps[gx][gy])
+    {
+        // map file name
+        char *tmp = nullptr;
+        // Pihhan: dataPath length + "maps/" + 3+2+2+ ".map" length may be > 32 !
+        int len = sWorld->GetDataPath().length()+strlen("maps/%03u%02u%02u.map")+1;
+        tmp = new char[len];
+        snprintf(tmp, len, (char *)(sWorld->GetDataPath() + "maps/%03u%02u%02u.map").c_str(), GetId(), gx, gy);
+        TC_LOG_DEBUG("maps","Loading map %s",tmp);
+        // loading data
+        GridMaps[gx][gy] = new GridMap();
+        if (!GridMaps[gx][gy]->loadData(tmp))
+            TC_LOG_ERROR("maps","ERROR loading map file: \n %s\n", tmp);
+
+        delete [] tmp;
+    }
 
     sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
 }
@@ -195,14 +213,14 @@ void Map::DeleteStateMachine()
 }
 
 Map::Map(MapType type, uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _parent)
-   : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
+   : _regionUpdateInProgress(false), i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
    _creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMoveLock(false),
    i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), _lastMapUpdate(0),
    m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
    m_activeForcedNonPlayersIter(m_activeForcedNonPlayers.end()), 
    _transportsUpdateIter(_transports.end()),
    _defaultLight(GetDefaultMapLight(id)),
-   i_mapType(type), i_gridExpiry(expiry), _respawnCheckTimer(0),
+   i_mapType(type), i_gridExpiry(expiry), _respawnCheckTimer(0), _gridPrefetchTimer(0),
    i_scriptLock(false), m_disableMapObjects(false), GameTime(WorldGameTime::GetGameTime()), GameMSTime(WorldGameTime::GetGameTimeMS())
 {
     m_parentMap = (_parent ? _parent : this);
@@ -326,7 +344,7 @@ void Map::SwitchGridContainers(Creature* obj, bool on)
         return;
 
     /*
-    if (sLog->ShouldLog("maps", LOG_LEVEL_DEBUG))
+    if (sLog->ShouldLog(TC_LOG_CATEGORY("maps"), LOG_LEVEL_DEBUG))
     {
     // Extract bitfield values
     uint32 const grid_x = cell.data.Part.grid_x;
@@ -373,7 +391,7 @@ void Map::SwitchGridContainers(GameObject* obj, bool on)
         return;
 
     /*
-    if (sLog->ShouldLog("maps", LOG_LEVEL_DEBUG))
+    if (sLog->ShouldLog(TC_LOG_CATEGORY("maps"), LOG_LEVEL_DEBUG))
     {
         // Extract bitfield values
         uint32 const grid_x = cell.data.Part.grid_x;
@@ -426,6 +444,8 @@ void Map::DeleteFromWorld(MotionTransport* transport)
 
 void Map::EnsureGridCreated(const GridCoord &p)
 {
+    auto regionLock = LockForRegions();
+
     std::lock_guard<std::mutex> lock(_gridLock);
     EnsureGridCreated_i(p);
 }
@@ -470,6 +490,8 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
 
 void Map::EnsureGridLoaded(const Cell& cell)
 {
+    auto regionLock = LockForRegions();
+
     EnsureGridCreated(GridCoord(cell.GridX(), cell.GridY()));
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -498,6 +520,8 @@ void Map::LoadGrid(float x, float y)
 
 bool Map::AddPlayerToMap(Player* player)
 {
+    auto regionLock = LockForRegions();
+
     // update player state for other player and visa-versa
     CellCoord cellCoord = Trinity::ComputeCellCoord(player->GetPositionX(), player->GetPositionY());
     if (!cellCoord.IsCoordValid())
@@ -573,6 +597,8 @@ bool Map::AddToMap(T* obj, bool checkTransport)
 
     assert(obj);
 
+    auto regionLock = LockForRegions();
+
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -694,6 +720,8 @@ struct ResetNotifier
 
 void Map::ProcessRelocationNotifies(const uint32 diff)
 {
+    TRACE_SCOPE("map", "ProcessRelocationNotifies");
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
     {
         NGridType *grid = i->GetSource();
@@ -785,10 +813,9 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
             // marked cells are those that have been visited
             // don't visit the same cell twice
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (isCellMarked(cell_id))
+            if (testAndMarkCell(cell_id))
                 continue;
 
-            markCell(cell_id);
             CellCoord pair(x, y);
             Cell cell(pair);
             cell.SetNoCreate();
@@ -815,6 +842,8 @@ void Map::DoUpdate(uint32 maxDiff, uint32 minimumTimeSinceLastUpdate /* = 0*/)
 
 void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 {
+    auto regionLock = LockForRegions();
+
     // Nothing to do if no change
     if (oldZone == newZone)
         return;
@@ -830,6 +859,8 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 
 void Map::Update(const uint32& t_diff)
 {
+    TRACE_SCOPE_ARG("map", "Map::Update", GetId());
+
     GameTime = time(nullptr);
     GameMSTime = GetMSTime();
 
@@ -856,71 +887,59 @@ void Map::Update(const uint32& t_diff)
     else
         _respawnCheckTimer -= t_diff;
 
+    if (_gridPrefetchTimer <= t_diff)
+    {
+        for (auto& ref : m_mapRefManager)
+            if (Player* player = ref.GetSource())
+                if (player->IsInWorld())
+                    PrefetchGridsAhead(player);
+
+        _gridPrefetchTimer = GRID_PREFETCH_INTERVAL;
+    }
+    else
+        _gridPrefetchTimer -= t_diff;
+
     resetMarkedCells();
 
+#ifdef PLAYERBOT
+    UpdatePlayerbotsThinking(t_diff);
+#endif
+
     Trinity::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
     TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for(m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    if (!UpdateRegions(t_diff))
     {
-        Player* player = m_mapRefIter->GetSource();
-
-        if (!player || !player->IsInWorld())
-            continue;
-
-        // update players at tick
-        player->Update(t_diff);
-
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        // the player iterator is stored in the map object
+        // to make sure calls to Map::Remove don't invalidate it
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->GetSource();
 
-        // If player is using far sight or mind vision, visit that object too
-        if (WorldObject* viewPoint = player->GetViewpoint())
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            if (!player || !player->IsInWorld())
+                continue;
 
-        // Handle updates for creatures in combat with player and are more than 60 yards away
-        if (player->IsInCombat())
-        {
-            std::vector<Unit*> toVisit;
-            for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
-                if (Creature* unit = pair.second->GetOther(player)->ToCreature())
-                    if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.push_back(unit);
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+            UpdatePlayerAndNearbyCells(player, t_diff, grid_object_update, world_object_update);
         }
 
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
-            {
-                if (Unit* caster = pair.second->GetBase()->GetCaster())
-                    if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
-            }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
-        }
-    }
+        //must be done before creatures update
+        for (auto itr : CreatureGroupHolder)
+            itr.second->Update(t_diff);
 
-    //must be done before creatures update
-    for (auto itr : CreatureGroupHolder)
-        itr.second->Update(t_diff);
-    
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeForcedNonPlayersIter = m_activeForcedNonPlayers.begin(); m_activeForcedNonPlayersIter != m_activeForcedNonPlayers.end();)
-    {
-        WorldObject* obj = *m_activeForcedNonPlayersIter;
-        ++m_activeForcedNonPlayersIter;
+        // non-player active objects, increasing iterator in the loop in case of object removal
+        for (m_activeForcedNonPlayersIter = m_activeForcedNonPlayers.begin(); m_activeForcedNonPlayersIter != m_activeForcedNonPlayers.end();)
+        {
+            WorldObject* obj = *m_activeForcedNonPlayersIter;
+            ++m_activeForcedNonPlayersIter;
 
-        if (!obj || !obj->IsInWorld())
-            continue;
+            if (!obj || !obj->IsInWorld())
+                continue;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        }
     }
 
     //update our transports
@@ -955,8 +974,106 @@ void Map::Update(const uint32& t_diff)
     sScriptMgr->OnMapUpdate(this, t_diff);
 }
 
+void Map::PrefetchGridsAhead(Player* player)
+{
+    GridPrefetcher* prefetcher = sMapMgr->GetGridPrefetcher();
+    if (!prefetcher->IsEnabled())
+        return;
+
+    auto prefetchAt = [&](float x, float y)
+    {
+        if (!Trinity::IsValidMapCoord(x, y))
+            return;
+
+        GridCoord p = Trinity::ComputeGridCoord(x, y);
+        if (IsGridLoaded(p))
+            return;
+
+        prefetcher->Prefetch(GetId(), (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord);
+    };
+
+    // grids within visibility range are loaded anyway, look further
+    float const maxDistance = GetVisibilityRange() + GRID_PREFETCH_DISTANCE;
+
+    if (player->IsInFlight())
+    {
+        // follow the flight path
+        MotionMaster* motionMaster = player->GetMotionMaster();
+        if (motionMaster->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+            return;
+
+        FlightPathMovementGenerator* flight = static_cast<FlightPathMovementGenerator*>(motionMaster->GetCurrentMovementGenerator());
+        TaxiPathNodeList const& path = flight->GetPath();
+        float distance = 0.0f;
+        float lastX = player->GetPositionX();
+        float lastY = player->GetPositionY();
+        for (uint32 i = flight->GetCurrentNode(); i < path.size(); ++i)
+        {
+            TaxiPathNodeEntry const* node = path[i];
+            if (node->MapID != GetId())
+                break;
+
+            distance += std::sqrt((node->LocX - lastX) * (node->LocX - lastX) + (node->LocY - lastY) * (node->LocY - lastY));
+            if (distance > maxDistance)
+                break;
+
+            prefetchAt(node->LocX, node->LocY);
+            lastX = node->LocX;
+            lastY = node->LocY;
+        }
+        return;
+    }
+
+    if (!player->isMoving())
+        return;
+
+    // straight ahead, only fast movements can outrun synchronous loading
+    float const speed = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    float const distance = std::min(GetVisibilityRange() + speed * GRID_PREFETCH_LOOKAHEAD / IN_MILLISECONDS, maxDistance);
+    for (float d = SIZE_OF_GRIDS / 4; d <= distance; d += SIZE_OF_GRIDS / 4)
+        prefetchAt(player->GetPositionX() + d * std::cos(player->GetOrientation()), player->GetPositionY() + d * std::sin(player->GetOrientation()));
+}
+
+void Map::UpdatePlayerAndNearbyCells(Player* player, uint32 t_diff, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer>& gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer>& worldVisitor)
+{
+    // update players at tick
+    player->Update(t_diff);
+
+    VisitNearbyCellsOf(player, gridVisitor, worldVisitor);
+
+    // If player is using far sight or mind vision, visit that object too
+    if (WorldObject* viewPoint = player->GetViewpoint())
+        VisitNearbyCellsOf(viewPoint, gridVisitor, worldVisitor);
+
+    // Handle updates for creatures in combat with player and are more than 60 yards away
+    if (player->IsInCombat())
+    {
+        std::vector<Unit*> toVisit;
+        for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
+            if (Creature* unit = pair.second->GetOther(player)->ToCreature())
+                if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                    toVisit.push_back(unit);
+        for (Unit* unit : toVisit)
+            VisitNearbyCellsOf(unit, gridVisitor, worldVisitor);
+    }
+
+    { // Update any creatures that own auras the player has applications of
+        std::unordered_set<Unit*> toVisit;
+        for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
+        {
+            if (Unit* caster = pair.second->GetBase()->GetCaster())
+                if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                    toVisit.insert(caster);
+        }
+        for (Unit* unit : toVisit)
+            VisitNearbyCellsOf(unit, gridVisitor, worldVisitor);
+    }
+}
+
 void Map::RemovePlayerFromMap(Player* player, bool remove)
 {
+    auto regionLock = LockForRegions();
+
     // Before leaving map, update zone/area for stats
     player->UpdateZone(MAP_INVALID_ZONE, 0);
     sScriptMgr->OnPlayerLeaveMap(this, player);
@@ -967,6 +1084,7 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 
     bool const inWorld = player->IsInWorld();
     player->RemoveFromWorld();
+    _updateDatas.RemovePlayer(player);
 
     SendRemoveTransports(player);
 
@@ -985,6 +1103,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    auto regionLock = LockForRegions();
+
     bool const inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -1190,6 +1310,8 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegions();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1200,6 +1322,8 @@ void Map::AddCreatureToMoveList(Creature *c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    auto regionLock = LockForRegions();
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1209,6 +1333,8 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegions();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1219,6 +1345,8 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
 
 void Map::RemoveGameObjectFromMoveList(GameObject* go)
 {
+    auto regionLock = LockForRegions();
+
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1228,6 +1356,8 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, float z, float ang)
 {
+    auto regionLock = LockForRegions();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1238,6 +1368,8 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
 
 void Map::RemoveDynamicObjectFromMoveList(DynamicObject* dynObj)
 {
+    auto regionLock = LockForRegions();
+
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1697,6 +1829,8 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
 
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
 {
+    auto regionLock = LockForRegions();
+
     G3D::Vector3 startPos = G3D::Vector3(x1, y1, z1);
     G3D::Vector3 dstPos = G3D::Vector3(x2, y2, z2);
     
@@ -2257,6 +2391,8 @@ float Map::GetCeil(Position const& pos, float maxSearchDist /*= DEFAULT_HEIGHT_S
 
 float Map::GetGameObjectCeil(uint32 phasemask, float x, float y, float z, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/, float collisionHeight /*= 0.0f*/) const
 {
+    auto regionLock = LockForRegions();
+
     return _dynamicTree.getCeil(x, y, z + collisionHeight, maxSearchDist, phasemask);
 }
 
@@ -2265,9 +2401,12 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     if ((checks & LINEOFSIGHT_CHECK_VMAP)
         && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
         return false;
-    if (/*sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && */(checks & LINEOFSIGHT_CHECK_GOBJECT)
-        && !_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask))
-        return false;
+    if (/*sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && */(checks & LINEOFSIGHT_CHECK_GOBJECT))
+    {
+        auto regionLock = LockForRegions();
+        if (!_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask))
+            return false;
+    }
     return true;
 }
 
@@ -2413,26 +2552,22 @@ inline void Map::setNGrid(NGridType *grid, uint32 x, uint32 y)
 
 void Map::SendObjectUpdates()
 {
-    //build updates for each objects
-    UpdateDataMapType update_players; //one UpdateData object per player, containing updates for all objects
-    UpdatePlayerSet player_set; //only there for performance, avoid recreating it at each BuildUpdate call
+    TRACE_SCOPE("map", "SendObjectUpdates");
 
-    while (!_updateObjects.empty())
+    //build updates for each objects, _updateDatas contains one UpdateData per player with updates for all objects
+    while (Object* obj = _updateObjects.PopFront())
     {
-        Object* obj = *_updateObjects.begin();
         ASSERT(obj->IsInWorld());
-
-        _updateObjects.erase(_updateObjects.begin());
-        obj->BuildUpdate(update_players, player_set);
+        obj->BuildUpdate(_updateDatas);
     }
 
     WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (auto & update_player : update_players)
+    _updateDatas.Consume([&packet](Player* player, UpdateData& data)
     {
-        update_player.second.BuildPacket(&packet, false);
-        update_player.first->GetSession()->SendPacket(&packet);
+        data.BuildPacket(&packet, false);
+        player->GetSession()->SendPacket(&packet);
         packet.clear();                                     // clean the string
-    }
+    });
 }
 
 void Map::AddFarSpellCallback(FarSpellCallback&& callback)
@@ -2442,6 +2577,8 @@ void Map::AddFarSpellCallback(FarSpellCallback&& callback)
 
 void Map::DelayedUpdate(const uint32 t_diff)
 {
+    TRACE_SCOPE_ARG("map", "Map::DelayedUpdate", GetId());
+
     {
         FarSpellCallback* callback;
         while (_farSpellCallbacks.Dequeue(callback))
@@ -2481,6 +2618,8 @@ void Map::DelayedUpdate(const uint32 t_diff)
 
 void Map::AddObjectToRemoveList(WorldObject *obj)
 {
+    auto regionLock = LockForRegions();
+
     assert(obj->GetMapId()==GetId() && obj->GetInstanceId()==GetInstanceId());
 
     obj->CleanupsBeforeDelete(false); 
@@ -2491,6 +2630,8 @@ void Map::AddObjectToRemoveList(WorldObject *obj)
 
 void Map::AddObjectToSwitchList(WorldObject *obj, bool on)
 {
+    auto regionLock = LockForRegions();
+
     assert(obj->GetMapId()==GetId() && obj->GetInstanceId()==GetInstanceId());
 
     auto itr = i_objectsToSwitch.find(obj);
@@ -2584,8 +2725,14 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket* data) const
 {
+    auto regionLock = LockForRegions();
+
+    if (m_mapRefManager.isEmpty())
+        return;
+
+    SharedWorldPacket sharedData = std::make_shared<WorldPacket const>(*data);
     for(const auto & itr : m_mapRefManager)
-        itr.GetSource()->SendDirectMessage(data);
+        itr.GetSource()->SendDirectMessage(sharedData);
 }
 
 bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
@@ -2668,26 +2815,36 @@ Player* Map::GetPlayer(ObjectGuid const& guid)
 
 Corpse* Map::GetCorpse(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegions();
+
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    auto regionLock = LockForRegions();
+
     return _objectsStore.Find<Creature>(guid);
 }
 
 GameObject* Map::GetGameObject(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegions();
+
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegions();
+
     return _objectsStore.Find<Pet>(guid);
 }
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid const& guid)
 {
+    auto regionLock = LockForRegions();
+
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
@@ -2725,6 +2882,8 @@ WorldObject* Map::GetWorldObject(ObjectGuid const& guid)
 
 Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto regionLock = LockForRegions();
+
     auto const bounds = GetCreatureBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -2739,6 +2898,8 @@ Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto regionLock = LockForRegions();
+
     auto const bounds = GetGameObjectBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -2801,6 +2962,37 @@ std::list<Creature*> Map::GetAllCreaturesFromPool(uint32 poolId)
     return creatureList;
 }
 
+#ifdef PLAYERBOT
+void Map::UpdatePlayerbotsThinking(uint32 t_diff)
+{
+    if (!sPlayerbotThinkPool.IsActive())
+        return;
+
+    std::vector<PlayerbotAI*> bots;
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        PlayerbotAI* ai = player->GetPlayerbotAI();
+        if (ai && ai->IsThinkDue(t_diff))
+            bots.push_back(ai);
+    }
+
+    // a single bot gains nothing from being handed to another thread
+    if (bots.size() < 2)
+        return;
+
+    TRACE_SCOPE_ARG("playerbot", "Map::UpdatePlayerbotsThinking", bots.size());
+
+    // Nothing else runs on this map meanwhile, but bots still may load grids or query the dynamic tree from several threads
+    _regionUpdateInProgress = true;
+    sPlayerbotThinkPool.Think(bots);
+    _regionUpdateInProgress = false;
+}
+#endif
+
 bool Map::AllTransportsEmpty() const
 {
     for (auto _transport : _transports)
@@ -3674,6 +3866,8 @@ bool Map::IsBattlegroundOrArena() const { return i_mapEntry && i_mapEntry->IsBat
 
 void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 entry, time_t respawnTime, uint32 zoneId, uint32 gridId, bool writeDB, bool replace, SQLTransaction dbTrans)
 {
+    auto regionLock = LockForRegions();
+
     if (!respawnTime)
     {
         // Delete only
@@ -4218,6 +4412,8 @@ static void PushRespawnInfoFrom(std::vector<RespawnInfo*>& data, RespawnInfoMap
 }
 void Map::GetRespawnInfo(std::vector<RespawnInfo*>& respawnData, SpawnObjectTypeMask types, uint32 zoneId) const
 {
+    auto regionLock = LockForRegions();
+
     if (types & SPAWN_TYPEMASK_CREATURE)
         PushRespawnInfoFrom(respawnData, _creatureRespawnTimesBySpawnId, zoneId);
     if (types & SPAWN_TYPEMASK_GAMEOBJECT)
@@ -4226,6 +4422,8 @@ void Map::GetRespawnInfo(std::vector<RespawnInfo*>& respawnData, SpawnObjectType
 
 RespawnInfo* Map::GetRespawnInfo(SpawnObjectType type, ObjectGuid::LowType spawnId) const
 {
+    auto regionLock = LockForRegions();
+
     RespawnInfoMap const& map = GetRespawnMapForType(type);
     auto it = map.find(spawnId);
     if (it == map.end())
@@ -4260,6 +4458,8 @@ void Map::DeleteRespawnInfo(RespawnInfo* info)
 
 void Map::RemoveRespawnTime(RespawnInfo* info, bool doRespawn, SQLTransaction dbTrans)
 {
+    auto regionLock = LockForRegions();
+
     PreparedStatement* stmt;
     switch (info->type)
     {
@@ -4514,12 +4714,16 @@ bool Map::IsSpawnGroupActive(uint32 groupId) const
 
 void Map::RemoveGameObjectModel(GameObjectModel const& model) 
 { 
+    auto regionLock = LockForRegions();
+
     TC_LOG_TRACE("maps", "Map %u - Removed model %s", GetId(), model.name.c_str());
     _dynamicTree.remove(model); 
 }
 
 void Map::InsertGameObjectModel(GameObjectModel const& model) 
 {
+    auto regionLock = LockForRegions();
+
     TC_LOG_TRACE("maps", "Map %u - Added model %s", GetId(), model.name.c_str());
     DEBUG_ASSERT(!_dynamicTree.contains(model));
     _dynamicTree.insert(model); 
@@ -4527,6 +4731,8 @@ void Map::InsertGameObjectModel(GameObjectModel const& model)
 
 bool Map::ContainsGameObjectModel(GameObjectModel const& model) const 
 { 
+    auto regionLock = LockForRegions();
+
     return _dynamicTree.contains(model); 
 }
 
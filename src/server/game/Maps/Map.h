@@ -16,8 +16,10 @@
 #include "Transaction.h"
 #include "SharedDefines.h"
 #include "Optional.h"
+#include "UpdateData.h"
+#include "UpdateObjectList.h"
 
-#include <bitset>
+#include <atomic>
 #include <list>
 #include <mutex>
 
@@ -243,14 +245,27 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
 		void AddUpdateObject(Object* obj)
 		{
-			_updateObjects.insert(obj);
+			auto regionLock = LockForRegions();
+			_updateObjects.Add(obj);
 		}
 
 		void RemoveUpdateObject(Object* obj)
 		{
-			_updateObjects.erase(obj);
+			auto regionLock = LockForRegions();
+			_updateObjects.Remove(obj);
 		}
 
+        /* Lock to take before touching map wide containers when they may be accessed by several regions at once, see UpdateRegions.
+        Returns an empty lock when the map is not currently updating its regions. */
+        std::unique_lock<std::recursive_mutex> LockForRegions() const
+        {
+            if (!_regionUpdateInProgress)
+                return std::unique_lock<std::recursive_mutex>();
+
+            return std::unique_lock<std::recursive_mutex>(_regionLock);
+        }
+        bool IsUpdatingRegions() const { return _regionUpdateInProgress; }
+
         virtual std::string GetDebugInfo() const;
 
         // some calls like isInWater should not use vmaps due to processor power
@@ -282,6 +297,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool ContainsGameObjectModel(GameObjectModel const& model) const;
         float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH, float collisionHeight = 0.0f) const
         {
+            auto regionLock = LockForRegions();
             return _dynamicTree.getHeight(x, y, z, maxSearchDist + collisionHeight, phasemask);
         }
         Transport* GetTransportForPos(uint32 phase, float x, float y, float z, WorldObject* worldobject = nullptr);
@@ -390,9 +406,19 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 		Corpse* ConvertCorpseToBones(ObjectGuid const& ownerGuid, bool insignia = false);
 		void RemoveOldCorpses();
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        void resetMarkedCells()
+        {
+            for (auto& word : marked_cells)
+                word.store(0, std::memory_order_relaxed);
+        }
+        bool isCellMarked(uint32 pCellId) const { return (marked_cells[pCellId / 64].load(std::memory_order_relaxed) & (uint64(1) << (pCellId % 64))) != 0; }
+        void markCell(uint32 pCellId) { marked_cells[pCellId / 64].fetch_or(uint64(1) << (pCellId % 64), std::memory_order_relaxed); }
+        //mark cell and return whether it was already marked. Regions may mark cells sharing the same word concurrently.
+        bool testAndMarkCell(uint32 pCellId)
+        {
+            uint64 const bit = uint64(1) << (pCellId % 64);
+            return (marked_cells[pCellId / 64].fetch_or(bit, std::memory_order_relaxed) & bit) != 0;
+        }
 
 		TempSummon* SummonCreature(uint32 entry, Position const& pos, SummonPropertiesEntry const* properties = nullptr, uint32 duration = 0, Unit* summoner = nullptr, uint32 spellId = 0);
         void SummonCreatureGroup(uint8 group, std::list<TempSummon*>* list = nullptr);
@@ -607,6 +633,20 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
 		void SendObjectUpdates();
 
+        // Update given player and all cells around it (and around the units it is fighting with)
+        void UpdatePlayerAndNearbyCells(Player* player, uint32 t_diff, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer>& gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer>& worldVisitor);
+        /* Continents only. Split players and active objects into independent regions and update them in parallel, using the MapUpdater region workers.
+        Regions are built so that objects of two different regions are always further than visibility distance from each other.
+        Map wide containers are protected by LockForRegions while this is running.
+        Returns false if the map was not eligible for a regions update this tick, in which case nothing was updated. */
+        bool UpdateRegions(uint32 t_diff);
+        // Ask GridPrefetcher to load grids the player is heading to
+        void PrefetchGridsAhead(Player* player);
+#ifdef PLAYERBOT
+        // Let due bots evaluate their triggers in parallel using PlayerbotThinkPool, their actions are then executed from their own Player::Update
+        void UpdatePlayerbotsThinking(uint32 t_diff);
+#endif
+
         bool AllTransportsEmpty() const; // sunwell
         void AllTransportsRemovePassengers(); // sunwell
         TransportsContainer const& GetAllTransports() const { return _transports; }
@@ -619,6 +659,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         std::mutex _mapLock;
         std::mutex _gridLock;
+        mutable std::recursive_mutex _regionLock;
+        bool _regionUpdateInProgress;
 
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
@@ -654,7 +696,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap* GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         uint16 GridMapReference[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::atomic<uint64> marked_cells[TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP / 64] = {};
 
 		//these functions used to process player/mob aggro reactions and
 		//visibility calculations. Highly optimized for massive calculations
@@ -752,12 +794,14 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         template<class T>
         void AddToForceActiveHelper(T* obj)
         {
+            auto regionLock = LockForRegions();
             m_activeForcedNonPlayers.insert(obj);
         }
 
         template<class T>
         void RemoveFromForceActiveHelper(T* obj)
         {
+            auto regionLock = LockForRegions();
             // Map::Update for active object in proccess
             if(m_activeForcedNonPlayersIter != m_activeForcedNonPlayers.end())
             {
@@ -785,6 +829,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_set<uint32> _toggledSpawnGroupIds;
 
         uint32 _respawnCheckTimer;
+        uint32 _gridPrefetchTimer;
         std::unordered_map<uint32, uint32> _zonePlayerCountMap;
 
         ZoneDynamicInfoMap _zoneDynamicInfo;
@@ -808,7 +853,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 		std::unordered_map<ObjectGuid, Corpse*> _corpsesByPlayer;
 		std::unordered_set<Corpse*> _corpseBones;
 
-		std::unordered_set<Object*> _updateObjects;
+		UpdateObjectList _updateObjects;
+		UpdateDataArena _updateDatas; // kept between updates to reuse players buffers, see SendObjectUpdates
         uint32 _lastMapUpdate;
 
         MPSCQueue<FarSpellCallback> _farSpellCallbacks;
@@ -30,9 +30,12 @@ void MapManager::Initialize()
     Map::InitStateMachine();
 
     int num_threads(sWorld->getIntConfig(CONFIG_NUMTHREADS));
+    int num_region_threads(sWorld->getBoolConfig(CONFIG_MAP_REGION_UPDATE) ? sWorld->getIntConfig(CONFIG_MAP_REGION_UPDATE_THREADS) : 0);
     // Start mtmaps if needed.
     if (num_threads > 0)
-        m_updater.activate(num_threads);
+        m_updater.activate(num_threads, num_region_threads);
+
+    m_gridPrefetcher.Start(sWorld->getIntConfig(CONFIG_GRID_PREFETCH_THREADS));
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -274,6 +277,8 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    m_gridPrefetcher.Stop();
+
     Map::DeleteStateMachine();
 }
 
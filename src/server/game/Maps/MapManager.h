@@ -5,6 +5,7 @@
 #include "Define.h"
 #include "Map.h"
 #include "MapUpdater.h"
+#include "GridPrefetcher.h"
 #include "MapInstanced.h"
 #include "GridStates.h"
 
@@ -99,6 +100,7 @@ class TC_GAME_API MapManager
         void SetNextInstanceId(uint32 nextInstanceId) { _nextInstanceId = nextInstanceId; };
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridPrefetcher* GetGridPrefetcher() { return &m_gridPrefetcher; }
 
         void MapCrashed(Map& map);
 
@@ -130,6 +132,7 @@ class TC_GAME_API MapManager
         InstanceIds _instanceIds;
         uint32 _nextInstanceId;
         MapUpdater m_updater;
+        GridPrefetcher m_gridPrefetcher;
 
 		// atomic op counter for active scripts amount
 		std::atomic<std::size_t> _scheduledScripts;
@@ -0,0 +1,206 @@
+#include "Map.h"
+#include "MapManager.h"
+#include "MapUpdater.h"
+#include "CellImpl.h"
+#include "CreatureGroups.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "SpellAuras.h"
+#include "Tracing.h"
+#include "World.h"
+
+/*
+Regions update:
+Players and active objects are grouped in regions so that the cells updated by two different regions are always separated by at least
+MAX_VISIBILITY_DISTANCE. Regions are then updated in parallel, the continent thread and the MapUpdater region workers sharing the work.
+Regions are built from grids rather than from cells, this is a bit more conservative but keeps the merge cheap with a lot of players.
+Everything that is not a player or nearby cells update (sessions, transports, object updates, scripts, relocation notifies...) stays serial.
+*/
+
+namespace
+{
+    uint32 FindRegionRoot(std::vector<uint32>& parents, uint32 index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    }
+
+    void MergeRegions(std::vector<uint32>& parents, uint32 a, uint32 b)
+    {
+        a = FindRegionRoot(parents, a);
+        b = FindRegionRoot(parents, b);
+        if (a != b)
+            parents[a] = b;
+    }
+}
+
+bool Map::UpdateRegions(uint32 t_diff)
+{
+    if (Instanceable() || !sWorld->getBoolConfig(CONFIG_MAP_REGION_UPDATE))
+        return false;
+
+    MapUpdater* mapUpdater = sMapMgr->GetMapUpdater();
+    if (!mapUpdater->activated() || !mapUpdater->regionUpdateEnabled())
+        return false;
+
+    // one entry per task, either a player or a non player active object
+    std::vector<WorldObject*> taskObjects;
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.GetSource();
+        if (player && player->IsInWorld())
+            taskObjects.push_back(player);
+    }
+
+    if (taskObjects.size() < sWorld->getIntConfig(CONFIG_MAP_REGION_UPDATE_MIN_PLAYERS))
+        return false;
+
+    for (WorldObject* obj : m_activeForcedNonPlayers)
+        if (obj && obj->IsInWorld())
+            taskObjects.push_back(obj);
+
+    std::vector<uint32> parents(taskObjects.size());
+    for (uint32 i = 0; i < parents.size(); ++i)
+        parents[i] = i;
+
+    // Dilate each area by margin before looking at which grids it touches. Two areas in different regions are then at least 2 * margin cells apart.
+    uint32 const margin = uint32(std::ceil(MAX_VISIBILITY_DISTANCE / SIZE_OF_GRID_CELL));
+    std::unordered_map<uint32 /*gridId*/, uint32 /*task*/> gridOwners;
+    auto claimArea = [&](uint32 task, WorldObject const* obj)
+    {
+        if (!obj->IsPositionValid())
+            return;
+
+        CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), obj->GetGridActivationRange());
+        uint32 const lowGridX = (area.low_bound.x_coord > margin ? area.low_bound.x_coord - margin : 0) / MAX_NUMBER_OF_CELLS;
+        uint32 const lowGridY = (area.low_bound.y_coord > margin ? area.low_bound.y_coord - margin : 0) / MAX_NUMBER_OF_CELLS;
+        uint32 const highGridX = std::min<uint32>(area.high_bound.x_coord + margin, TOTAL_NUMBER_OF_CELLS_PER_MAP - 1) / MAX_NUMBER_OF_CELLS;
+        uint32 const highGridY = std::min<uint32>(area.high_bound.y_coord + margin, TOTAL_NUMBER_OF_CELLS_PER_MAP - 1) / MAX_NUMBER_OF_CELLS;
+
+        for (uint32 x = lowGridX; x <= highGridX; ++x)
+        {
+            for (uint32 y = lowGridY; y <= highGridY; ++y)
+            {
+                auto itr = gridOwners.emplace(x * MAX_NUMBER_OF_GRIDS + y, task);
+                if (!itr.second)
+                    MergeRegions(parents, task, itr.first->second);
+            }
+        }
+    };
+
+    // Units linked to a task unit write to its combat manager or aura lists (and the other way around) when updated, they must be in the same region
+    auto claimLinked = [&](uint32 task, WorldObject const* linked)
+    {
+        if (linked && linked->IsInWorld() && linked->GetMap() == this)
+            claimArea(task, linked);
+    };
+
+    for (uint32 task = 0; task < taskObjects.size(); ++task)
+    {
+        WorldObject* obj = taskObjects[task];
+        claimArea(task, obj);
+
+        // everything UpdatePlayerAndNearbyCells may visit must belong to the player region
+        if (Player* player = obj->ToPlayer())
+            if (WorldObject* viewPoint = player->GetViewpoint())
+                claimArea(task, viewPoint);
+
+        Unit* unit = obj->ToUnit();
+        if (!unit)
+            continue;
+
+        // both sides of every combat reference
+        for (auto const& pair : unit->GetCombatManager().GetPvECombatRefs())
+            claimLinked(task, pair.second->GetOther(unit));
+        for (auto const& pair : unit->GetCombatManager().GetPvPCombatRefs())
+            claimLinked(task, pair.second->GetOther(unit));
+
+        // casters of auras on the unit, targets of auras it owns and owners of the single target auras it cast
+        for (std::pair<uint32, AuraApplication*> pair : unit->GetAppliedAuras())
+            if (pair.second->GetBase()->GetCasterGUID() != unit->GetGUID())
+                claimLinked(task, pair.second->GetBase()->GetCaster());
+        for (std::pair<uint32, Aura*> pair : unit->GetOwnedAuras())
+            for (auto const& application : pair.second->GetApplicationMap())
+                claimLinked(task, application.second->GetTarget());
+        for (Aura* aura : unit->GetSingleCastAuras())
+            claimLinked(task, aura->GetOwner());
+
+        ObjectGuid const channelTarget = unit->GetChannelObjectGuid();
+        if (!channelTarget.IsEmpty())
+            claimLinked(task, ObjectAccessor::GetWorldObject(*unit, channelTarget));
+    }
+
+    std::unordered_map<uint32 /*root task*/, std::vector<uint32>> regionsByRoot;
+    for (uint32 task = 0; task < taskObjects.size(); ++task)
+        regionsByRoot[FindRegionRoot(parents, task)].push_back(task);
+
+    if (regionsByRoot.size() < 2)
+        return false;
+
+    std::vector<std::vector<uint32>> regions;
+    regions.reserve(regionsByRoot.size());
+    for (auto& itr : regionsByRoot)
+        regions.push_back(std::move(itr.second));
+
+    // start with the biggest regions so that the last ones to finish are small
+    std::sort(regions.begin(), regions.end(), [](std::vector<uint32> const& a, std::vector<uint32> const& b) { return a.size() > b.size(); });
+
+    // Players and active objects removed during the update must not touch those iterators, we're using our own lists
+    m_mapRefIter = m_mapRefManager.end();
+    m_activeForcedNonPlayersIter = m_activeForcedNonPlayers.end();
+
+    // players then active non-player objects of each region, with creature groups updated in between as in Map::Update
+    auto makeTasks = [this, &taskObjects, &regions, t_diff](bool players)
+    {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(regions.size());
+        for (std::vector<uint32> const& region : regions)
+        {
+            tasks.push_back([this, &taskObjects, &region, t_diff, players]()
+            {
+                TRACE_SCOPE_ARG("map", "Map::UpdateRegion", region.size());
+
+                Trinity::ObjectUpdater updater(t_diff);
+                TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+                TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+                for (uint32 task : region)
+                {
+                    WorldObject* obj = taskObjects[task];
+                    if (!obj->IsInWorld())
+                        continue;
+
+                    Player* player = obj->ToPlayer();
+                    if (players != (player != nullptr))
+                        continue;
+
+                    if (player)
+                        UpdatePlayerAndNearbyCells(player, t_diff, grid_object_update, world_object_update);
+                    else
+                        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+                }
+            });
+        }
+        return tasks;
+    };
+
+    _regionUpdateInProgress = true;
+    mapUpdater->runRegionTasks(makeTasks(true));
+    _regionUpdateInProgress = false;
+
+    //must be done before creatures update
+    for (auto itr : CreatureGroupHolder)
+        itr.second->Update(t_diff);
+
+    _regionUpdateInProgress = true;
+    mapUpdater->runRegionTasks(makeTasks(false));
+    _regionUpdateInProgress = false;
+
+    return true;
+}
@@ -19,6 +19,8 @@
 /// Put scripts in the execution queue
 void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const& scripts, uint32 id, Object* source, Object* target, bool start)
 {
+    auto regionLock = LockForRegions();
+
     ///- Find the script map
     auto s = scripts.find(id);
     if (s == scripts.end())
@@ -58,6 +60,8 @@ void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
 {
+    auto regionLock = LockForRegions();
+
     ASSERT(source);
     ASSERT(target);
     // NOTE: script record _must_ exist until command executed
@@ -1,4 +1,3 @@
-
 #include <mutex>
 #include <condition_variable>
 
@@ -7,8 +6,14 @@
 #include "Monitor.h"
 #include "World.h"
 #include "MapManager.h"
+#include "Tracing.h"
 
 #define MINIMUM_MAP_UPDATE_INTERVAL 30
+//how long an idle worker waits before checking again when all queued requests were updated too recently
+#define MAP_UPDATER_IDLE_RECHECK_MS 2
+
+//index of the worker running on this thread, -1 if this isn't a MapUpdater worker
+static thread_local int32 currentWorkerIndex = -1;
 
 class MapUpdateRequest
 {
@@ -18,25 +23,52 @@ class MapUpdateRequest
         MapUpdater& m_updater;
         uint32 m_diff;
         uint32 m_loopCount;
+        bool m_loop;
+        uint32 m_priority;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d) :
+        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d, bool loop) :
             m_map(m), 
             m_updater(u), 
             m_diff(d), 
-            m_loopCount(0)
+            m_loopCount(0),
+            m_loop(loop),
+            m_priority(0)
         {
+            // MapInstanced update is cheap and schedules all its instances, get it done first
+            if (m.GetMapType() == MAP_TYPE_MAP_INSTANCED)
+                m_priority = std::numeric_limits<uint32>::max();
+            else
+                m_priority = sMonitor->GetLastDiffForMap(m);
         }
 
         Map const* getMap() { return &m_map; }
+        bool isLoop() const { return m_loop; }
+
+        //once maps come first, then the maps which took the most time on their last update
+        bool isMoreUrgentThan(MapUpdateRequest const& other) const
+        {
+            if (m_loop != other.m_loop)
+                return !m_loop;
+
+            return m_priority > other.m_priority;
+        }
+
+        //don't update a map again if its last update was less than MINIMUM_MAP_UPDATE_INTERVAL ago
+        bool isReady(uint32 now) const
+        {
+            return GetMSTimeDiff(m_map.GetLastMapUpdateTime(), now) >= MINIMUM_MAP_UPDATE_INTERVAL;
+        }
 
         void call()
         {
+            uint32 const startTime = GetMSTime();
             sMonitor->MapUpdateStart(m_map);
             m_map.DoUpdate(m_diff, MINIMUM_MAP_UPDATE_INTERVAL);
             sMonitor->MapUpdateEnd(m_map);
             m_loopCount++;
+            m_priority = GetMSTimeDiffToNow(startTime);
         }
 };
 
@@ -46,34 +78,53 @@ MapUpdater::~MapUpdater()
         deactivate();
 }
 
-void MapUpdater::activate(size_t num_threads)
+void MapUpdater::activate(size_t num_threads, size_t num_region_threads)
 {
-    //spawn instances & battlegrounds threads
     for (size_t i = 0; i < num_threads; ++i)
-        _loop_maps_workerThreads.push_back(std::thread(&MapUpdater::LoopWorkerThread, this, &_enable_updates_loop));
+        _workers.push_back(std::make_unique<Worker>());
+
+    //start threads only once all workers exist, they may steal from each others right away
+    for (size_t i = 0; i < num_threads; ++i)
+        _workers[i]->thread = std::thread(&MapUpdater::WorkerThread, this, i);
 
-    //continents threads are spawned later when request are received
+    for (size_t i = 0; i < num_region_threads; ++i)
+        _region_workerThreads.push_back(std::thread(&MapUpdater::RegionWorkerThread, this));
 }
 
 void MapUpdater::deactivate()
 {
     _cancelationToken = true;
 
-    _loop_queue.Cancel();
-    _once_queue.Cancel();
+    _region_queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_work_lock);
+        _work_condition.notify_all();
+    }
 
-    waitUpdateOnces();
-    waitUpdateLoops();
+    for (auto& worker : _workers)
+        worker->thread.join();
 
-    for (auto& thread : _once_maps_workerThreads)
+    for (auto& thread : _region_workerThreads)
         thread.join();
 
-    _once_maps_workerThreads.clear();
+    _region_workerThreads.clear();
 
-    for (auto& thread : _loop_maps_workerThreads)
-        thread.join();
+    //drop requests which were still queued
+    for (auto& worker : _workers)
+    {
+        for (MapUpdateRequest* request : worker->requests)
+        {
+            if (request->isLoop())
+                loopMapFinished();
+            else
+                onceMapFinished();
+
+            delete request;
+        }
+    }
 
-    _loop_maps_workerThreads.clear();
+    _workers.clear();
+    _queued_requests = 0;
 }
 
 void MapUpdater::waitUpdateOnces()
@@ -101,87 +152,123 @@ void MapUpdater::waitUpdateLoops()
     lock.unlock();
 }
 
-void MapUpdater::spawnMissingOnceUpdateThreads()
-{
-    for (uint32 i = _once_maps_workerThreads.size(); i < pending_once_maps; i++)
-        _once_maps_workerThreads.push_back(std::thread(&MapUpdater::OnceWorkerThread, this));
-}
-
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
-
-    MapUpdateRequest* request = new MapUpdateRequest(map, *this, diff);
     // MapInstanced re schedule the instances it contains by itself, so we want to call it only once
     // Also currently test maps needs to be updated once per world update
-    if((map.Instanceable() && map.GetMapType() != MAP_TYPE_MAP_INSTANCED) || map.GetMapType() == MAP_TYPE_TEST_MAP) 
-    { 
+    bool const loop = (map.Instanceable() && map.GetMapType() != MAP_TYPE_MAP_INSTANCED) || map.GetMapType() == MAP_TYPE_TEST_MAP;
+    MapUpdateRequest* request = new MapUpdateRequest(map, *this, diff, loop);
+    if (loop)
         pending_loop_maps++;
-        _loop_queue.Push(request);
-    } 
-    else 
-    {
+    else
         pending_once_maps++;
-        _once_queue.Push(request);
-    }
 
-    spawnMissingOnceUpdateThreads();
+    //keep requests scheduled by a worker (instances from a MapInstanced) on that worker, others will steal them if needed
+    size_t const workerIndex = currentWorkerIndex >= 0 ? size_t(currentWorkerIndex) : (_next_worker++ % _workers.size());
+    pushRequest(request, workerIndex);
 }
 
 bool MapUpdater::activated()
 {
-    return _loop_maps_workerThreads.size() > 0;
+    return _workers.size() > 0;
 }
 
-void MapUpdater::LoopWorkerThread(std::atomic<bool>* enable_instance_updates_loop)
+void MapUpdater::pushRequest(MapUpdateRequest* request, size_t workerIndex)
 {
-    while (1)
+    Worker& worker = *_workers[workerIndex];
     {
-        MapUpdateRequest* request = nullptr;
+        std::lock_guard<std::mutex> lock(worker.lock);
+        auto itr = std::find_if(worker.requests.begin(), worker.requests.end(), [request](MapUpdateRequest const* queued) { return request->isMoreUrgentThan(*queued); });
+        worker.requests.insert(itr, request);
+        ++_queued_requests;
+    }
+
+    std::lock_guard<std::mutex> lock(_work_lock);
+    _work_condition.notify_one();
+}
+
+MapUpdateRequest* MapUpdater::takeRequest(Worker& worker, uint32 now)
+{
+    std::lock_guard<std::mutex> lock(worker.lock);
+    for (auto itr = worker.requests.begin(); itr != worker.requests.end(); ++itr)
+    {
+        if (!(*itr)->isReady(now))
+            continue;
 
-        _loop_queue.WaitAndPop(request);
+        MapUpdateRequest* request = *itr;
+        worker.requests.erase(itr);
+        --_queued_requests;
+        return request;
+    }
 
-        if (_cancelationToken) 
+    return nullptr;
+}
+
+void MapUpdater::WorkerThread(size_t workerIndex)
+{
+    currentWorkerIndex = int32(workerIndex);
+    sTracing->SetThreadName("Map updater " + std::to_string(workerIndex));
+
+    while (!_cancelationToken)
+    {
+        uint32 const now = GetMSTime();
+        MapUpdateRequest* request = takeRequest(*_workers[workerIndex], now);
+        //nothing left for us, steal from the others
+        for (size_t i = 1; !request && i < _workers.size(); ++i)
+            request = takeRequest(*_workers[(workerIndex + i) % _workers.size()], now);
+
+        if (!request)
         {
-            if(request)
-                loopMapFinished();
-            return;
+            std::unique_lock<std::mutex> lock(_work_lock);
+            if (_cancelationToken)
+                break;
+
+            if (_queued_requests == 0)
+                _work_condition.wait(lock);
+            else //some requests are queued but were updated too recently
+                _work_condition.wait_for(lock, std::chrono::milliseconds(MAP_UPDATER_IDLE_RECHECK_MS));
+
+            continue;
         }
 
-        ASSERT(request);
         request->call();
 
-        //repush at end of queue, or delete if loop has been disabled by MapManager
-        if(!(*enable_instance_updates_loop))
+        if (!request->isLoop())
+        {
+            delete request;
+            onceMapFinished();
+        }
+        //requeue, or delete if loop has been disabled by MapManager
+        else if (_enable_updates_loop)
+            pushRequest(request, workerIndex);
+        else
         {
             delete request;
             loopMapFinished();
-        } else {
-            _loop_queue.Push(request);
         }
     }
 }
 
-void MapUpdater::OnceWorkerThread()
+void MapUpdater::runRegionTasks(std::vector<std::function<void()>>&& tasks)
+{
+    TaskBatch::Run(_region_queue, _region_workerThreads.size(), std::move(tasks));
+}
+
+void MapUpdater::RegionWorkerThread()
 {
+    sTracing->SetThreadName("Map region updater");
+
     while (1)
     {
-        MapUpdateRequest* request = nullptr;
+        TaskBatch::Ptr batch;
 
-        _once_queue.WaitAndPop(request);
+        _region_queue.WaitAndPop(batch);
 
-        if (_cancelationToken) 
-        {
-            if(request)
-                onceMapFinished();
+        if (_cancelationToken)
             return;
-        }
-
-        ASSERT(request);
-        request->call();
 
-        delete request;
-        onceMapFinished();
+        if (batch)
+            batch->Work();
     }
 }
 
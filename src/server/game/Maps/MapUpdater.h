@@ -6,7 +6,11 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include "ProducerConsumerQueue.h"
+#include "TaskBatch.h"
 
 class MapUpdateRequest;
 class Map;
@@ -15,12 +19,16 @@ class Map;
 Two kinds of maps:
 - Maps we update only once (continents, instances base maps)
 - Maps we keep updating until the first type has finished (instances, battlegrounds)
+
+Both are handled by a fixed pool of workers. Each worker has its own queue, sorted so that once maps come first, then maps with the
+biggest last update diff. A worker with nothing left in its queue steals from the other workers queues, so that a slow continent
+never leaves the other workers waiting at the end of a world tick.
 */
 class MapUpdater
 {
 public:
 
-    MapUpdater() : _cancelationToken(false), _enable_updates_loop(false), pending_once_maps(0), pending_loop_maps(0) {}
+    MapUpdater() : _cancelationToken(false), _enable_updates_loop(false), pending_once_maps(0), pending_loop_maps(0), _queued_requests(0), _next_worker(0) {}
     ~MapUpdater();
 
     friend class MapUpdateRequest;
@@ -32,24 +40,35 @@ public:
     void enableUpdateLoop(bool enable);
     void waitUpdateLoops();
 
-    void activate(size_t num_threads);
+    //num_region_threads: additional threads used to update continents regions in parallel, see Map::UpdateRegions
+    void activate(size_t num_threads, size_t num_region_threads = 0);
 
     void deactivate();
 
     bool activated();
+
+    //Run given tasks in parallel using the region workers. The calling thread takes part in the work, and this returns once all tasks are done.
+    void runRegionTasks(std::vector<std::function<void()>>&& tasks);
+    bool regionUpdateEnabled() const { return !_region_workerThreads.empty(); }
 private:
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<MapUpdateRequest*> requests; //most urgent first
+        std::thread thread;
+    };
 
     void onceMapFinished();
     void loopMapFinished();
 
-	//this will ensure once_map_workerThreads match the pending_once_maps count
-	void spawnMissingOnceUpdateThreads();
+    //insert request in given worker queue, keeping it sorted
+    void pushRequest(MapUpdateRequest* request, size_t workerIndex);
+    //take the most urgent request ready to be updated from given worker queue, if any
+    MapUpdateRequest* takeRequest(Worker& worker, uint32 now);
 
-    ProducerConsumerQueue<MapUpdateRequest*> _loop_queue;
-	ProducerConsumerQueue<MapUpdateRequest*> _once_queue;
-
-    std::vector<std::thread> _loop_maps_workerThreads; 
-    std::vector<std::thread> _once_maps_workerThreads; //created/deleted at each loop, one for each continent
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _region_workerThreads;
+    ProducerConsumerQueue<TaskBatch::Ptr> _region_queue;
     std::atomic<bool> _cancelationToken;
     std::atomic<bool> _enable_updates_loop;
 
@@ -61,12 +80,19 @@ private:
     std::atomic<uint32> pending_once_maps;
     std::atomic<uint32> pending_loop_maps;
 
-    /* Loop workers keep running and processing _loop_queue, updating maps and requeuing them afterwards.
-    When onceMapsFinished becomes true, the worker finish the current request and delete the request instead of requeuing it.
+    //idle workers wait on this until some request is pushed
+    std::mutex _work_lock;
+    std::condition_variable _work_condition;
+    std::atomic<uint32> _queued_requests;
+    //requests scheduled from outside the workers are spread over them
+    std::atomic<uint32> _next_worker;
+
+    /* Workers update requests from their own queue, or steal from the other queues when empty.
+    Loop requests are requeued after update until the update loop gets disabled by MapManager, once requests are deleted.
     */
-    void LoopWorkerThread(std::atomic<bool>* onceMapsFinished);
-    //Single update, descrease pending_once_maps when done
-	void OnceWorkerThread();
+    void WorkerThread(size_t workerIndex);
+    //Help with region batches pushed by continents threads
+    void RegionWorkerThread();
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -90,17 +90,14 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
     if (_transport)
         _transport->CalculatePassengerOffset(destX, destY, destZ);
 
-    if (!_navMeshQuery || !_navMesh)
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        if (_transport)
-            _navMeshQuery = mmap->GetModelNavMeshQuery(_transport->GetDisplayId());
-        else
-            _navMeshQuery = mmap->GetNavMeshQuery(_sourceMapId, _sourceInstanceId);
+    // queries belong to the thread using them, and the unit may be updated by another thread than last time (map regions)
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    if (_transport)
+        _navMeshQuery = mmap->GetModelNavMeshQuery(_transport->GetDisplayId());
+    else
+        _navMeshQuery = mmap->GetNavMeshQuery(_sourceMapId, _sourceInstanceId);
 
-        if (_navMeshQuery)
-            _navMesh = _navMeshQuery->getAttachedNavMesh();
-    }
+    _navMesh = _navMeshQuery ? _navMeshQuery->getAttachedNavMesh() : nullptr;
 
     //reset last result if any
     _type = PATHFIND_BLANK;
@@ -1078,7 +1078,7 @@ private:
             auto name = itr->first;
             rebuild_buildfiles = !itr->second.empty();
 
-            if (sLog->ShouldLog("scripts.hotswap", LogLevel::LOG_LEVEL_TRACE))
+            if (sLog->ShouldLog(TC_LOG_CATEGORY("scripts.hotswap"), LogLevel::LOG_LEVEL_TRACE))
                 for (auto const& entry : itr->second)
                 {
                     TC_LOG_TRACE("scripts.hotswap", "Source file %s was %s.",
@@ -5,6 +5,8 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 #include "Opcodes.h"
+#include <atomic>
+#include <memory>
 
 class TC_GAME_API WorldPacket : public ByteBuffer
 {
@@ -58,8 +60,15 @@ class TC_GAME_API WorldPacket : public ByteBuffer
         uint16 GetOpcode() const { return m_opcode; }
         void SetOpcode(uint16 opcode) { m_opcode = opcode; }
 
+        // Link used by the lock free queues of received packets, see WorldSession::QueuePacket
+        std::atomic<WorldPacket*> QueueLink;
+
     protected:
         uint16 m_opcode;
 };
 
+/* Immutable packet, queued by reference on every socket it is sent to instead of being copied for each of them.
+Use it when sending the same packet to several players (see Map::SendToPlayers, Group::BroadcastPacket...) */
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 #endif
@@ -39,6 +39,7 @@
 #include "ReplayPlayer.h"
 #include "PlayerAntiCheat.h"
 #include "GuildMgr.h"
+#include "Tracing.h"
 
 #ifdef PLAYERBOT
 #include "playerbot.h"
@@ -126,6 +127,7 @@ m_timeSyncClockDelta(0),
 m_timeSyncCounter(0),
 m_timeSyncTimer(0),
 m_timeSyncServer(0),
+_recvPacketPoolSize(0),
 _clientControl(this)
 {
     memset(m_Tutorials, 0, sizeof(m_Tutorials));
@@ -159,9 +161,12 @@ WorldSession::~WorldSession()
 
     ///- empty incoming packet queue
     WorldPacket* packet = nullptr;
-    while (_recvQueue.next(packet))
+    while (_recvQueue.Dequeue(packet))
         delete packet;
 
+    for (WorldPacket* recvPacket : _recvPackets)
+        delete recvPacket;
+
     LoginDatabase.AsyncPQuery("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());
     CharacterDatabase.AsyncPQuery("UPDATE characters SET online = 0 WHERE account = %u;", GetAccountId());
 }
@@ -184,6 +189,30 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
 }
 
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    SendPacketImpl(packet, nullptr);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket const& packet)
+{
+    SendPacketImpl(packet.get(), &packet);
+}
+
+bool WorldSession::IsPacketIgnored(uint16 opcode) const
+{
+    if (m_Socket)
+        return false;
+
+#ifdef PLAYERBOT
+    if (_player)
+        if (PlayerbotAI* ai = _player->GetPlayerbotAI())
+            return !ai->IsOutgoingPacketHandled(opcode);
+#endif
+
+    return true;
+}
+
+void WorldSession::SendPacketImpl(WorldPacket const* packet, SharedWorldPacket const* sharedPacket)
 {
     ASSERT(packet->GetOpcode() != NULL_OPCODE);
 
@@ -240,7 +269,10 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     //    sScriptMgr->OnPacketSend(this, *packet);
 
     TC_LOG_TRACE("network.opcode", "S->C: %s %s", GetPlayerInfo().c_str(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())).c_str());
-    m_Socket->SendPacket(*packet);
+    if (sharedPacket)
+        m_Socket->SendPacket(*sharedPacket);
+    else
+        m_Socket->SendPacket(*packet);
 
     // Log packet for replay
     if (m_replayRecorder)
@@ -251,7 +283,33 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     anticheat.OnClientPacketReceived(*new_packet);
-    _recvQueue.add(new_packet);
+    _recvQueue.Enqueue(new_packet);
+}
+
+WorldPacket* WorldSession::AllocateRecvPacket()
+{
+    WorldPacket* packet = nullptr;
+    if (_recvPacketPool.Dequeue(packet))
+    {
+        --_recvPacketPoolSize;
+        return packet;
+    }
+
+    return new WorldPacket();
+}
+
+void WorldSession::RecycleRecvPacket(WorldPacket* packet)
+{
+// enough to cover the packets received by a client between two updates
+#define MAX_RECV_PACKET_POOL_SIZE 32
+    if (_recvPacketPoolSize >= MAX_RECV_PACKET_POOL_SIZE)
+    {
+        delete packet;
+        return;
+    }
+
+    ++_recvPacketPoolSize;
+    _recvPacketPool.Enqueue(packet);
 }
 
 /// Logging helper for unexpected opcodes
@@ -264,7 +322,7 @@ void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* status,
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 {
-    if (!sLog->ShouldLog("network.opcode", LOG_LEVEL_TRACE) || packet->rpos() >= packet->wpos())
+    if (!sLog->ShouldLog(TC_LOG_CATEGORY("network.opcode"), LOG_LEVEL_TRACE) || packet->rpos() >= packet->wpos())
         return;
 
     TC_LOG_TRACE("network.opcode", "Unprocessed tail data (read stop at %u from %u) Opcode %s from %s",
@@ -275,6 +333,8 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 {
+    TRACE_SCOPE_ARG("session", "WorldSession::Update", GetAccountId());
+
     #ifdef PLAYERBOT
     if (GetPlayer() && GetPlayer()->GetPlayerbotAI()) return true;
     #endif
@@ -292,7 +352,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
             {
                 TC_LOG_ERROR("network.opcode","Client from account %u timed out. Dumping last packet sent since last response (up to 10) :",GetAccountId());
                 for(auto itr : list)
-                    sPacketLog->DumpPacket(LOG_LEVEL_ERROR,SERVER_TO_CLIENT,itr,GetPlayerInfo());
+                    sPacketLog->DumpPacket(LOG_LEVEL_ERROR,SERVER_TO_CLIENT,*itr,GetPlayerInfo());
 
                 lock.unlock_shared(); //unlock before calling ClearLastPacketsSent
                 TC_LOG_ERROR("network.opcode","==================================================================");
@@ -317,13 +377,23 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     if(_player)
         _player->SetHasMovedInUpdate(false);
 
-    while (m_Socket && _recvQueue.next(packet, updater))
+    //take everything received since last update at once, what's not processed now stays in _recvPackets for next update
+    while (_recvQueue.Dequeue(packet))
+        _recvPackets.push_back(packet);
+
+    while (m_Socket && !_recvPackets.empty())
     {
+        packet = _recvPackets.front();
+        if (!updater.Process(packet))
+            break;
+
+        _recvPackets.pop_front();
+
         //if replaying record, skip most packets
         if (m_replayPlayer)
             if (!m_replayPlayer->OpcodeAllowedWhileReplaying(Opcodes(packet->GetOpcode())))
             {
-                delete packet;
+                RecycleRecvPacket(packet);
                 continue;
             }
 
@@ -432,7 +502,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
-            delete packet;
+            RecycleRecvPacket(packet);
 
         //restore default behavior for next packet
         deletePacket = true;
@@ -453,7 +523,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         GetPlayer()->GetPlayerbotMgr()->UpdateSessions(0);
     #endif
 
-    _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
+    _recvPackets.insert(_recvPackets.begin(), requeuePackets.begin(), requeuePackets.end());
 
     if (_player && _player->IsRepopPending() && !GetClientControl().HasPendingMovementChange())
         _player->RepopAtGraveyard();
@@ -526,6 +596,8 @@ bool WorldSession::IsConnectionIdle() const
 
 void WorldSession::ProcessQueryCallbacks()
 {
+    TRACE_SCOPE("db", "WorldSession::ProcessQueryCallbacks");
+
     _queryProcessor.ProcessReadyQueries();
 
     if (_realmAccountLoginCallback.valid() && _realmAccountLoginCallback.wait_for(0s) == std::future_status::ready)
@@ -1637,8 +1709,14 @@ void WorldSession::HandleSpellClick(WorldPacket& recvData)
 void WorldSession::HandleBotPackets()
 {
     WorldPacket* packet;
-    while (_recvQueue.next(packet))
+    while (_recvQueue.Dequeue(packet))
+        _recvPackets.push_back(packet);
+
+    while (!_recvPackets.empty())
     {
+        packet = _recvPackets.front();
+        _recvPackets.pop_front();
+
         ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
         opHandle->Call(this, *packet);
         delete packet;
@@ -10,6 +10,7 @@
 #include "QueryCallback.h"
 #include "PlayerAntiCheat.h"
 #include "World.h"
+#include "MPSCQueue.h"
 
 #include <string>
 
@@ -244,6 +245,10 @@ class TC_GAME_API WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const* packet);
+        /// Same packet sent to several sessions, the socket queues it without copying it
+        void SendPacket(SharedWorldPacket const& packet);
+        /// Nobody will ever read packets with this opcode sent to this session (bots, disconnected sessions), no need to build them
+        bool IsPacketIgnored(uint16 opcode) const;
         void SendNotification(const char *format,...) ATTR_PRINTF(2,3);
         void SendNotification(int32 string_id,...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName *declinedName);
@@ -311,6 +316,8 @@ class TC_GAME_API WorldSession
         bool ValidateHyperlinksAndMaybeKick(std::string const& str);
 
         void QueuePacket(WorldPacket* new_packet);
+        // Get a packet to be given to QueuePacket, recycled from the packets already processed if possible. Called by the network thread.
+        WorldPacket* AllocateRecvPacket();
         
         bool Update(uint32 diff, PacketFilter& updater);
 
@@ -965,6 +972,9 @@ class TC_GAME_API WorldSession
 
         bool CanUseBank(ObjectGuid bankerGUID = ObjectGuid::Empty) const;
 
+        // sharedPacket is packet when it may be queued by reference
+        void SendPacketImpl(WorldPacket const* packet, SharedWorldPacket const* sharedPacket);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
         void LogUnprocessedTail(WorldPacket* packet);
@@ -1015,7 +1025,14 @@ class TC_GAME_API WorldSession
         bool forceExit;
         ObjectGuid m_currentBankerGUID;
 
-        LockedQueue<WorldPacket*> _recvQueue;
+        // Packets pushed by the network thread (or bots), drained at once at the beginning of each Update
+        MPSCQueue<WorldPacket, &WorldPacket::QueueLink> _recvQueue;
+        // Packets drained from _recvQueue but not processed yet, only accessed by the thread updating the session
+        std::deque<WorldPacket*> _recvPackets;
+        // Processed packets given back to the network thread, see AllocateRecvPacket
+        MPSCQueue<WorldPacket, &WorldPacket::QueueLink> _recvPacketPool;
+        std::atomic<uint32> _recvPacketPoolSize;
+        void RecycleRecvPacket(WorldPacket* packet);
 
         std::shared_ptr<ReplayRecorder> m_replayRecorder;
         std::shared_ptr<ReplayPlayer> m_replayPlayer;
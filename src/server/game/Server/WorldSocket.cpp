@@ -10,24 +10,31 @@
 #include "DatabaseEnv.h"
 #include "AccountMgr.h"
 #include "ServerPktHeader.h"
+#include "UpdateData.h"
 #include <boost/asio/ip/tcp.hpp>
 #include "LogsDatabaseAccessor.h"
 
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
+    EncryptablePacket(SharedWorldPacket packet, bool encrypt) : _packet(std::move(packet)), _encrypt(encrypt) { }
 
+    SharedWorldPacket const& GetPacket() const { return _packet; }
     bool NeedsEncryption() const { return _encrypt; }
 
 private:
+    SharedWorldPacket _packet; // may be queued on other sockets as well, never modify it
     bool _encrypt;
 };
 
 using boost::asio::ip::tcp;
 
+// packets with a payload at least this big are sent from their own storage instead of being copied in the send buffer
+#define SEND_ZERO_COPY_MIN_SIZE 4096
+#define SEND_BUFFER_MIN_SIZE 1024
+
 WorldSocket::WorldSocket(tcp::socket&& socket)
-    : Socket(std::move(socket)), _authSeed(rand32()), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _authCrypt(nullptr), _sendBufferSize(4096)
+    : Socket(std::move(socket)), _authSeed(rand32()), _OverSpeedPings(0), _worldSession(nullptr), _authed(false), _authCrypt(nullptr), _sendBufferSize(65536), _averageFlushSize(0)
 {
     _headerBuffer.Resize(sizeof(ClientPktHeader));
 }
@@ -79,40 +86,67 @@ void WorldSocket::CheckIpCallback(PreparedQueryResult result)
 bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
-    MessageBuffer buffer(_sendBufferSize);
+    // allocated with the first packet, most updates have nothing to send. Shared by all segments queued from it.
+    std::shared_ptr<MessageBuffer> buffer;
+    std::size_t coalescedSize = 0;
+
+    // queue what was written to the coalescing buffer since last time, next packets are still coalesced after it
+    auto queueCoalesced = [&]()
+    {
+        if (buffer && buffer->GetActiveSize() > 0)
+        {
+            QueueSharedBuffer(buffer, buffer->GetReadPointer(), buffer->GetActiveSize());
+            buffer->ReadCompleted(buffer->GetActiveSize());
+        }
+    };
+
+    bool const compressUpdates = sWorld->getBoolConfig(CONFIG_COMPRESSION_IN_NETWORK_THREADS);
     while (_bufferQueue.Dequeue(queued))
     {
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
-        if (_authCrypt && queued->NeedsEncryption())
-            _authCrypt->EncryptSend(header.header, header.getHeaderLength());
+        SharedWorldPacket packet = queued->GetPacket();
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
+        // update packets left uncompressed by map threads, see UpdateData::BuildPacket
+        // the queued packet may be shared with other sockets, compress into our own copy
+        if (compressUpdates && packet->GetOpcode() == SMSG_UPDATE_OBJECT && packet->size() > UpdateData::COMPRESSION_THRESHOLD)
         {
-            QueuePacket(std::move(buffer));
-            buffer.Resize(_sendBufferSize);
+            std::shared_ptr<WorldPacket> compressed = std::make_shared<WorldPacket>();
+            if (UpdateData::CompressPacket(*packet, compressed.get()))
+                packet = std::move(compressed);
         }
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
+        ServerPktHeader header(packet->size() + 2, packet->GetOpcode());
+        if (_authCrypt && queued->NeedsEncryption())
+            _authCrypt->EncryptSend(header.header, header.getHeaderLength());
+
+        // big payloads are not copied, they're queued by reference right after their header
+        bool const zeroCopy = packet->size() >= SEND_ZERO_COPY_MIN_SIZE;
+        std::size_t const copiedSize = header.getHeaderLength() + (zeroCopy ? 0 : packet->size());
+        coalescedSize += copiedSize;
+
+        if (!buffer || buffer->GetRemainingSpace() < copiedSize)
         {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
+            queueCoalesced();
+            buffer = std::make_shared<MessageBuffer>(std::max(GetCoalescingBufferSize(), copiedSize));
         }
-        else    // single packet larger than 4096 bytes
-        {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
 
-            QueuePacket(std::move(packetBuffer));
+        buffer->Write(header.header, header.getHeaderLength());
+        if (zeroCopy)
+        {
+            // header goes right before the payload, the rest of the buffer is used for the next packets
+            queueCoalesced();
+            QueueSharedBuffer(packet, packet->contents(), packet->size());
         }
+        else if (!packet->empty())
+            buffer->Write(packet->contents(), packet->size());
 
         delete queued;
     }
 
-    if (buffer.GetActiveSize() > 0)
-        QueuePacket(std::move(buffer));
+    queueCoalesced();
+
+    // smoothed size of what we coalesce per update (shared payloads excluded), only counting updates which sent something
+    if (coalescedSize)
+        _averageFlushSize = (_averageFlushSize * 7 + coalescedSize) / 8;
 
     if (!BaseSocket::Update())
         return false;
@@ -122,6 +156,16 @@ bool WorldSocket::Update()
     return true;
 }
 
+std::size_t WorldSocket::GetCoalescingBufferSize() const
+{
+    // big enough for what this connection usually sends in one update, so that it's coalesced in a single buffer
+    std::size_t size = SEND_BUFFER_MIN_SIZE;
+    while (size < _averageFlushSize && size < _sendBufferSize)
+        size *= 2;
+
+    return std::min(size, std::max<std::size_t>(_sendBufferSize, SEND_BUFFER_MIN_SIZE));
+}
+
 void WorldSocket::HandleSendAuthSession()
 {
     WorldPacket packet(SMSG_AUTH_CHALLENGE, 4);
@@ -388,8 +432,11 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
         // Our Idle timer will reset on any non PING opcodes on login screen, allowing us to catch people idling.
         _worldSession->ResetTimeOutTime(false);
 
-        // Copy the packet to the heap before enqueuing
-        _worldSession->QueuePacket(new WorldPacket(std::move(packet)));
+        // Move the packet to one recycled by the session before enqueuing, and keep the storage of that one for the next packet
+        WorldPacket* queuedPacket = _worldSession->AllocateRecvPacket();
+        std::swap(*queuedPacket, packet);
+        _packetBuffer = MessageBuffer(packet.Move());
+        _worldSession->QueuePacket(queuedPacket);
         break;
     }
     }
@@ -421,6 +468,16 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     if (!IsOpen())
         return;
 
+    SendPacket(std::make_shared<WorldPacket const>(packet));
+}
+
+void WorldSocket::SendPacket(SharedWorldPacket const& sharedPacket)
+{
+    if (!IsOpen())
+        return;
+
+    WorldPacket const& packet = *sharedPacket;
+
     if (sPacketLog->CanLogPacket())
         sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
 
@@ -431,10 +488,10 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     {
         boost::unique_lock<boost::shared_mutex> lock(_lastPacketsSent_mutex);
         if (_lastPacketsSent.size() < 10)
-            _lastPacketsSent.push_back(packet);
+            _lastPacketsSent.push_back(sharedPacket);
     }
 
-    _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt && _authCrypt->IsInitialized()));
+    _bufferQueue.Enqueue(new EncryptablePacket(sharedPacket, _authCrypt && _authCrypt->IsInitialized()));
 }
 
 void WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
@@ -712,7 +769,7 @@ bool WorldSocket::HandlePing(WorldPacket& recvPacket)
     return true;
 }
 
-std::list<WorldPacket> const& WorldSocket::GetLastPacketsSent()
+std::list<SharedWorldPacket> const& WorldSocket::GetLastPacketsSent()
 {
     return _lastPacketsSent;
 }
@@ -45,11 +45,14 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    /// Queue packet without copying it, only the header is built and encrypted for this connection
+    void SendPacket(SharedWorldPacket const& packet);
 
+    /// Max size of the buffers in which packets are coalesced, actual size depends on the connection throughput
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
     // see _lastPacketsSent. Use _lastPacketsSent_mutex while using it
-    std::list<WorldPacket> const& GetLastPacketsSent();
+    std::list<SharedWorldPacket> const& GetLastPacketsSent();
     boost::shared_mutex& GetLastPacketsSentMutex()
     {
         return _lastPacketsSent_mutex;
@@ -71,6 +74,7 @@ protected:
     ReadDataHandlerResult ReadDataHandler();
 
 private:
+    std::size_t GetCoalescingBufferSize() const;
     void CheckIpCallback(PreparedQueryResult result);
 
     /// writes network.opcode log
@@ -100,6 +104,7 @@ private:
     MessageBuffer _packetBuffer;
     MPSCQueue<EncryptablePacket> _bufferQueue;
     std::size_t _sendBufferSize;
+    std::size_t _averageFlushSize;
 
     QueryCallbackProcessor _queryProcessor;
     std::string _ipCountry;
@@ -107,7 +112,7 @@ private:
     /* This can be used for debug purpose when clients are experiencing crashes, this contains the last packets sent to it
     after the last client response. CONFIG_DEBUG_LOG_LAST_PACKETS must be enabled for this to be used.
     */
-    std::list<WorldPacket> _lastPacketsSent;
+    std::list<SharedWorldPacket> _lastPacketsSent;
     boost::shared_mutex _lastPacketsSent_mutex;
 };
 
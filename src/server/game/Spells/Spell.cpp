@@ -37,6 +37,10 @@
 #include "SpellHistory.h"
 #include "SpellPackets.h"
 #include "TradeData.h"
+#include "Tracing.h"
+#ifdef PLAYERBOT
+#include "playerbot.h"
+#endif
 
 extern SpellEffectHandlerFn SpellEffectHandlers[TOTAL_SPELL_EFFECTS];
 
@@ -4117,6 +4121,8 @@ void Spell::SendSpellCooldown()
 
 void Spell::update(uint32 difftime)
 {
+    TRACE_SCOPE_ARG("spell", "Spell::update", m_spellInfo->Id);
+
     //TC_LOG_DEBUG("FIXME","Spell %u - update",m_spellInfo->Id);
     // update pointers based at it's GUIDs
     if (!UpdatePointers())
@@ -4990,6 +4996,12 @@ void Spell::ExecuteLogEffectResurrect(uint8 effIndex, Unit* target)
 
 void Spell::SendInterrupted(uint8 result)
 {
+#ifdef PLAYERBOT
+    if (Player* player = m_caster->ToPlayer())
+        if (PlayerbotAI* ai = player->GetPlayerbotAI())
+            ai->SpellInterrupted(m_spellInfo->Id);
+#endif
+
 #ifdef LICH_KING
     WorldPacket data(SMSG_SPELL_FAILURE, (8+1+4+1));
 #else
@@ -7470,6 +7482,12 @@ void Spell::Delayed() // only called in DealDamage()
     else
         m_timer += delaytime;
 
+#ifdef PLAYERBOT
+    if (Player* player = caster->ToPlayer())
+        if (PlayerbotAI* ai = player->GetPlayerbotAI())
+            ai->SpellDelayed(delaytime);
+#endif
+
     WorldPacket data(SMSG_SPELL_DELAYED, 8+4);
     data << caster->GetPackGUID();
     data << uint32(delaytime);
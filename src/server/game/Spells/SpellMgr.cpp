@@ -198,6 +198,7 @@ void SpellMgr::LoadSpellGroups()
     uint32 oldMSTime = GetMSTime();
 
     mSpellSpellGroup.clear();                                  // need for reload case
+    mSpellSpellGroupOffsets.clear();
     mSpellGroupSpell.clear();
 
     //                                                0     1
@@ -265,10 +266,18 @@ void SpellMgr::LoadSpellGroups()
         for (auto spellItr = spells.begin(); spellItr != spells.end(); ++spellItr)
         {
             ++count;
-            mSpellSpellGroup.emplace(*spellItr, SpellGroup(*groupItr));
+            mSpellSpellGroup.emplace_back(*spellItr, SpellGroup(*groupItr));
         }
     }
 
+    // groups of each spell are contiguous, offsets give where they start for every spell id
+    std::sort(mSpellSpellGroup.begin(), mSpellSpellGroup.end());
+    mSpellSpellGroupOffsets.assign(GetSpellInfoStoreSize() + 1, 0);
+    for (auto const& spellGroup : mSpellSpellGroup)
+        ++mSpellSpellGroupOffsets[spellGroup.first + 1];
+    for (uint32 i = 1; i < mSpellSpellGroupOffsets.size(); ++i)
+        mSpellSpellGroupOffsets[i] += mSpellSpellGroupOffsets[i - 1];
+
     TC_LOG_INFO("server.loading", ">> Loaded %u spell group definitions in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -596,6 +605,7 @@ void SpellMgr::LoadSpellProcs()
     uint32 oldMSTime = GetMSTime();
 
     mSpellProcMap.clear();                             // need for reload case
+    mSpellProcIndex.clear();
 
     //                                                     0           1                2                3 
     QueryResult result = WorldDatabase.Query("SELECT SpellId, SchoolMask, SpellFamilyName, SpellFamilyMask, "
@@ -958,6 +968,10 @@ void SpellMgr::LoadSpellProcs()
         ++count;
     }
 
+    mSpellProcIndex.assign(GetSpellInfoStoreSize(), nullptr);
+    for (auto const& itr : mSpellProcMap)
+        mSpellProcIndex[itr.first] = &itr.second;
+
     TC_LOG_INFO("server.loading", ">> Generated spell proc data for %u spells in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -1004,6 +1018,7 @@ void SpellMgr::LoadSpellBonuses()
     uint32 oldMSTime = GetMSTime();
 
     mSpellBonusMap.clear();                             // need for reload case
+    mSpellBonusIndex.clear();
 
                                                         //                                                0      1             2          3         4
     QueryResult result = WorldDatabase.Query("SELECT entry, direct_bonus, dot_bonus, ap_bonus, ap_dot_bonus FROM spell_bonus_data");
@@ -1035,6 +1050,19 @@ void SpellMgr::LoadSpellBonuses()
         ++count;
     } while (result->NextRow());
 
+    mSpellBonusIndex.assign(GetSpellInfoStoreSize(), nullptr);
+    for (uint32 spellId = 0; spellId < mSpellBonusIndex.size(); ++spellId)
+    {
+        auto itr = mSpellBonusMap.find(spellId);
+        // Not found, use first spell rank data if any
+        if (itr == mSpellBonusMap.end())
+            if (uint32 rank_1 = GetFirstSpellInChain(spellId))
+                itr = mSpellBonusMap.find(rank_1);
+
+        if (itr != mSpellBonusMap.end())
+            mSpellBonusIndex[spellId] = &itr->second;
+    }
+
     TC_LOG_INFO("server.loading", ">> Loaded %u extra spell bonus data in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -2808,18 +2836,7 @@ bool SpellMgr::CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcE
 
 SpellBonusEntry const* SpellMgr::GetSpellBonusData(uint32 spellId) const
 {
-    // Lookup data
-    auto itr = mSpellBonusMap.find(spellId);
-    if (itr != mSpellBonusMap.end())
-        return &itr->second;
-    // Not found, try lookup for 1 spell rank if exist
-    if (uint32 rank_1 = GetFirstSpellInChain(spellId))
-    {
-        auto itr2 = mSpellBonusMap.find(rank_1);
-        if (itr2 != mSpellBonusMap.end())
-            return &itr2->second;
-    }
-    return nullptr;
+    return spellId < mSpellBonusIndex.size() ? mSpellBonusIndex[spellId] : nullptr;
 }
 
 SpellThreatEntry const* SpellMgr::GetSpellThreatEntry(uint32 spellID) const
@@ -3770,7 +3787,10 @@ void SpellMgr::LoadSpellInfoImmunities()
 SpellSpellGroupMapBounds SpellMgr::GetSpellSpellGroupMapBounds(uint32 spell_id) const
 {
     spell_id = GetFirstSpellInChain(spell_id);
-    return mSpellSpellGroup.equal_range(spell_id);
+    if (spell_id + 1 >= mSpellSpellGroupOffsets.size())
+        return SpellSpellGroupMapBounds(mSpellSpellGroup.end(), mSpellSpellGroup.end());
+
+    return SpellSpellGroupMapBounds(mSpellSpellGroup.begin() + mSpellSpellGroupOffsets[spell_id], mSpellSpellGroup.begin() + mSpellSpellGroupOffsets[spell_id + 1]);
 }
 
 bool SpellMgr::IsSpellMemberOfSpellGroup(uint32 spellid, SpellGroup groupid) const
@@ -602,8 +602,8 @@ namespace std
 
 #define SPELL_GROUP_DB_RANGE_MIN 1000
 
-//                  spell_id, group_id
-typedef std::unordered_multimap<uint32, SpellGroup> SpellSpellGroupMap;
+//                  spell_id, group_id, sorted by spell_id (see SpellMgr::mSpellSpellGroupOffsets)
+typedef std::vector<std::pair<uint32, SpellGroup>> SpellSpellGroupMap;
 typedef std::pair<SpellSpellGroupMap::const_iterator, SpellSpellGroupMap::const_iterator> SpellSpellGroupMapBounds;
 
 //                      group_id, spell_id
@@ -876,7 +876,7 @@ class TC_GAME_API SpellMgr
         // Spell proc events
         SpellProcEntry const* GetSpellProcEntry(uint32 spellId) const
         {
-            return Trinity::Containers::MapGetValuePtr(mSpellProcMap, spellId);
+            return spellId < mSpellProcIndex.size() ? mSpellProcIndex[spellId] : nullptr;
         }
         static bool CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo);
 
@@ -1084,6 +1084,11 @@ class TC_GAME_API SpellMgr
         SpellAreaForQuestAreaMap   mSpellAreaForQuestAreaMap;
 
         SpellInfoMap               mSpellInfoMap;
+
+        // Flat lookups by spell id for the tables read on every cast and proc, built by their loaders from the containers above
+        std::vector<SpellProcEntry const*>  mSpellProcIndex;
+        std::vector<SpellBonusEntry const*> mSpellBonusIndex;        // first rank data for ranks without their own
+        std::vector<uint32>                 mSpellSpellGroupOffsets; // groups of spell i are mSpellSpellGroup[offsets[i], offsets[i + 1])
 };
 
 #define sSpellMgr SpellMgr::instance()
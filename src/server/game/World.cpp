@@ -56,6 +56,7 @@
 #include "TicketMgr.h"
 #include "Transport.h"
 #include "TransportMgr.h"
+#include "Tracing.h"
 #include "UpdateTime.h"
 #include "Util.h"
 #include "WardenDataStorage.h"
@@ -64,6 +65,8 @@
 #include "Weather.h"
 #include "WhoListStorage.h"
 #include "World.h"
+#include "WorldDatabaseSnapshot.h"
+#include "WorldLoader.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #ifdef TESTS
@@ -72,6 +75,7 @@
 
 #ifdef PLAYERBOT
 #include "PlayerbotAIConfig.h"
+#include "PlayerbotThinkPool.h"
 #include "RandomPlayerbotMgr.h"
 #endif
 
@@ -606,6 +610,7 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading","Compression level (%i) must be in range 1..9. Using default compression level (1).",m_configs[CONFIG_COMPRESSION]);
         m_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_configs[CONFIG_COMPRESSION_IN_NETWORK_THREADS] = sConfigMgr->GetBoolDefault("Compression.InNetworkThreads", false);
     m_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfigMgr->GetBoolDefault("GridUnload", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfigMgr->GetIntDefault("PlayerSaveInterval", 60000);
@@ -1207,6 +1212,16 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_NO_RESET_TALENT_COST] = sConfigMgr->GetBoolDefault("NoResetTalentsCost", false);
     m_configs[CONFIG_SHOW_KICK_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowKickInWorld", false);
     m_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 4);
+    m_configs[CONFIG_MAP_REGION_UPDATE] = sConfigMgr->GetBoolDefault("MapUpdate.Regions.Enable", false);
+    m_configs[CONFIG_MAP_REGION_UPDATE_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.Regions.Threads", 4);
+    m_configs[CONFIG_MAP_REGION_UPDATE_MIN_PLAYERS] = sConfigMgr->GetIntDefault("MapUpdate.Regions.MinPlayers", 100);
+    m_configs[CONFIG_GRID_PREFETCH_THREADS] = sConfigMgr->GetIntDefault("GridPrefetch.Threads", 0);
+    m_configs[CONFIG_LOADING_THREADS] = sConfigMgr->GetIntDefault("Loading.Threads", 0);
+    if (m_configs[CONFIG_MAP_REGION_UPDATE] && (m_configs[CONFIG_NUMTHREADS] == 0 || m_configs[CONFIG_MAP_REGION_UPDATE_THREADS] == 0))
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.Regions.Enable requires both MapUpdate.Threads and MapUpdate.Regions.Threads to be greater than 0. Disabling map regions update.");
+        m_configs[CONFIG_MAP_REGION_UPDATE] = false;
+    }
 
     m_configs[CONFIG_WORLDCHANNEL_MINLEVEL] = sConfigMgr->GetIntDefault("WorldChannel.MinLevel", 10);
     m_configs[CONFIG_TICKET_LEVEL_REQ] = sConfigMgr->GetIntDefault("LevelReq.Ticket", 1);
@@ -1250,6 +1265,10 @@ void World::LoadConfigSettings(bool reload)
         m_configs[CONFIG_MONITORING_DYNAMIC_VIEWDIST_AVERAGE_COUNT] = 500;
     }
 
+    sTracing->SetBufferSize(sConfigMgr->GetIntDefault("Tracing.BufferSize", 65536));
+    sTracing->SetMinDuration(sConfigMgr->GetIntDefault("Tracing.MinDuration", 50));
+    sTracing->SetEnabled(sConfigMgr->GetBoolDefault("Tracing.Enable", false));
+
 
     std::string forbiddenmaps = sConfigMgr->GetStringDefault("ForbiddenMaps", "");
     auto  forbiddenMaps = new char[forbiddenmaps.length() + 1];
@@ -1481,9 +1500,6 @@ void World::SetInitialWorldSettings()
     LoadDBCStores(m_dataPath);
     DetectDBCLang();
 
-    // Load cinematic cameras
-    LoadM2Cameras(m_dataPath);
-
     std::vector<uint32> mapIds;
     for (uint32 mapId = 0; mapId < sMapStore.GetNumRows(); mapId++)
         if (sMapStore.LookupEntry(mapId))
@@ -1495,377 +1511,184 @@ void World::SetInitialWorldSettings()
     MMAP::MMapManager* mmmgr = MMAP::MMapFactory::createOrGetMMapManager();
     mmmgr->InitializeThreadUnsafe(mapIds);
 
-    TC_LOG_INFO("server.loading","Loading Item Extended Cost Data...");
-    sObjectMgr->LoadItemExtendedCost();
-
-    TC_LOG_INFO("server.loading","Loading Spell templates...");
-    sObjectMgr->LoadSpellTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading SkillLineAbilityMultiMap Data..." );
-    sSpellMgr->LoadSkillLineAbilityMap();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Required Data..." );
-    sSpellMgr->LoadSpellRequired();
-
     ///- Initialize static helper structures
     AIRegistry::Initialize();
 
-    TC_LOG_INFO("server.loading", "Loading SpellInfo store...");  //must be after all SpellEntry's alterations
-    sSpellMgr->LoadSpellInfoStore(false);
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo corrections...");
-    sSpellMgr->LoadSpellInfoCorrections();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo custom attributes...");
-    sSpellMgr->LoadSpellInfoCustomAttributes(); //must be after LoadSkillLineAbilityMap
-
-    TC_LOG_INFO("server.loading", "Loading Spell Elixir types..." ); //must be after SpellInfo
-    sSpellMgr->LoadSpellElixirs();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Rank Data...." ); //must be after LoadSkillLineAbilityMap and after SpellInfo
-    sSpellMgr->LoadSpellRanks();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Group types...");
-    sSpellMgr->LoadSpellGroups();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Skills..." );
-    sSpellMgr->LoadSpellLearnSkills();                        // must be after LoadSpellChains and after SpellInfo
-
-    TC_LOG_INFO("server.loading", "Loading Spell Learn Spells..." );  //must be after SpellInfo
-    sSpellMgr->LoadSpellLearnSpells();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Bonus Data...");
-    sSpellMgr->LoadSpellBonuses();
-
-    TC_LOG_INFO("server.loading", "Loading Threat Spells Definitions..."); //must be after SpellInfo
-    sSpellMgr->LoadSpellThreats();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Group Stack Rules...");
-    sSpellMgr->LoadSpellGroupStackRules();
-
-    TC_LOG_INFO("server.loading", "Loading Script Names...");
-    sObjectMgr->LoadScriptNames();
-
-    TC_LOG_INFO("server.loading", "Loading InstanceTemplate" );
-    sObjectMgr->LoadInstanceTemplate();
-
+    ///- Load world and dynamic data. Each lane runs its steps in order, lanes run in parallel with Loading.Threads > 1.
+    WorldLoader loader;
+
+    loader.Add("spell templates", "spells", [] { sObjectMgr->LoadSpellTemplates(); });
+    loader.Add("SkillLineAbilityMultiMap data", "spells", [] { sSpellMgr->LoadSkillLineAbilityMap(); });
+    loader.Add("spell required data", "spells", [] { sSpellMgr->LoadSpellRequired(); });
+    loader.Add("SpellInfo store", "spells", [] { sSpellMgr->LoadSpellInfoStore(false); }); // must be after all SpellEntry's alterations
+    loader.Add("SpellInfo corrections", "spells", [] { sSpellMgr->LoadSpellInfoCorrections(); });
+    loader.Add("SpellInfo custom attributes", "spells", [] { sSpellMgr->LoadSpellInfoCustomAttributes(); });
+    loader.Add("spell elixir types", "spells", [] { sSpellMgr->LoadSpellElixirs(); });
+    loader.Add("spell rank data", "spells", [] { sSpellMgr->LoadSpellRanks(); });
+    loader.Add("spell group types", "spells", [] { sSpellMgr->LoadSpellGroups(); });
+    loader.Add("spell learn skills", "spells", [] { sSpellMgr->LoadSpellLearnSkills(); });
+    loader.Add("spell learn spells", "spells", [] { sSpellMgr->LoadSpellLearnSpells(); });
+    loader.Add("spell bonus data", "spells", [] { sSpellMgr->LoadSpellBonuses(); });
+    loader.Add("threat spells definitions", "spells", [] { sSpellMgr->LoadSpellThreats(); });
+    loader.Add("spell group stack rules", "spells", [] { sSpellMgr->LoadSpellGroupStackRules(); });
+    loader.Add("enchant spells proc datas", "spells", [] { sSpellMgr->LoadSpellEnchantProcData(); });
+    loader.Add("SpellInfo diminishing infos", "spells", [] { sSpellMgr->LoadSpellInfoDiminishing(); });
+    loader.Add("SpellInfo immunity infos", "spells", [] { sSpellMgr->LoadSpellInfoImmunities(); });
+    loader.Add("spell target coordinates", "spells", [] { sSpellMgr->LoadSpellTargetPositions(); });
+    loader.Add("SpellAffect definitions", "spells", [] { sSpellMgr->LoadSpellAffects(); });
+    loader.Add("linked spells", "spells", [] { sSpellMgr->LoadSpellLinked(); });
+    loader.Add("spell proc conditions and data", "spells", [] { sSpellMgr->LoadSpellProcs(); }); // must be after LoadSpellAffects
+    loader.Add("spell pet auras", "spells", [] { sSpellMgr->LoadSpellPetAuras(); });
+    loader.Add("SpellItemEnchantment overrides", "spells", [] { sSpellMgr->OverrideSpellItemEnchantment(); });
+
+    loader.Add("cinematic cameras", "models", [this] { LoadM2Cameras(m_dataPath); });
+    loader.Add("GameObject models", "models", [this] { LoadGameObjectModelList(m_dataPath); });
+
+    loader.Add("broadcast texts", "locales", []
+    {
+        sObjectMgr->LoadBroadcastTexts();
+        sObjectMgr->LoadBroadcastTextLocales();
+    });
+    loader.Add("localization strings", "locales", [this]
+    {
+        sObjectMgr->LoadCreatureLocales();
+        sObjectMgr->LoadGameObjectLocales();
+        sObjectMgr->LoadItemLocales();
+        sObjectMgr->LoadQuestLocales();
+        sObjectMgr->LoadGossipTextLocales();
+        sObjectMgr->LoadPageTextLocales();
+        sObjectMgr->LoadGossipMenuItemsLocales();
+        sObjectMgr->LoadQuestGreetingsLocales();
+        sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
+    });
+
+    loader.Add("waypoints", "waypoints", [] { sWaypointMgr->Load(); });
+    loader.Add("SmartAI waypoints", "waypoints", [] { sSmartWaypointMgr->LoadFromDB(); });
+
+    loader.Add("item extended cost data", "objects", [] { sObjectMgr->LoadItemExtendedCost(); });
+    loader.Add("script names", "objects", [] { sObjectMgr->LoadScriptNames(); });
+    loader.Add("instance templates", "objects", [] { sObjectMgr->LoadInstanceTemplate(); });
+    loader.Add("page texts", "objects", [] { sObjectMgr->LoadPageTexts(); });
+    // from here objects loaders check the spells they reference
+    loader.Add("game object templates", "objects", { "spell group stack rules" }, [] { sObjectMgr->LoadGameObjectTemplate(); }); // must be after LoadPageTexts
+    loader.Add("NPC texts", "objects", { "broadcast texts" }, [] { sObjectMgr->LoadGossipText(); });
+    loader.Add("item random enchantments table", "objects", [] { LoadRandomEnchantmentsTable(); });
+    loader.Add("items", "objects", [] { sObjectMgr->LoadItemTemplates(); }); // must be after LoadRandomEnchantmentsTable and LoadPageTexts
+    loader.Add("creature model based info data", "objects", [] { sObjectMgr->LoadCreatureModelInfo(); });
+    loader.Add("creature templates", "objects", [] { sObjectMgr->LoadCreatureTemplates(false); });
+    loader.Add("equipment templates", "objects", [] { sObjectMgr->LoadEquipmentTemplates(); });
+    loader.Add("creature template addons", "objects", [] { sObjectMgr->LoadCreatureTemplateAddons(); });
+    loader.Add("creature reputation OnKill data", "objects", [] { sObjectMgr->LoadReputationOnKill(); });
+    loader.Add("points of interest data", "objects", [] { sObjectMgr->LoadPointsOfInterest(); });
+    loader.Add("pet create spells", "objects", [] { sObjectMgr->LoadPetCreateSpells(); });
+    loader.Add("creature base stats", "objects", [] { sObjectMgr->LoadCreatureClassLevelStats(); });
+    loader.Add("spawn group templates", "objects", [] { sObjectMgr->LoadSpawnGroupTemplates(); });
+    loader.Add("instance spawn groups", "objects", [] { sObjectMgr->LoadInstanceSpawnGroups(); });
+    if (!getConfig(CONFIG_DEBUG_DISABLE_CREATURES_LOADING))
+    {
+        loader.Add("creature data", "objects", [] { sObjectMgr->LoadCreatures(); });
+        loader.Add("creature addon data", "objects", [] { sObjectMgr->LoadCreatureAddons(); }); // must be after LoadCreatureTemplates() and LoadCreatures()
+        loader.Add("creature movement overrides", "objects", [] { sObjectMgr->LoadCreatureMovementOverrides(); }); // must be after LoadCreatures()
+    }
+    loader.Add("temporary summon data", "objects", [] { sObjectMgr->LoadTempSummons(); }); // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
+    if (!getConfig(CONFIG_DEBUG_DISABLE_GAMEOBJECTS_LOADING))
+        loader.Add("gameobject data", "objects", [] { sObjectMgr->LoadGameObjects(); });
+    loader.Add("spawn group data", "objects", [] { sObjectMgr->LoadSpawnGroups(); });
+    loader.Add("transport templates", "objects", [] { sTransportMgr->LoadTransportTemplates(); });
+    loader.Add("weather data", "objects", [] { sObjectMgr->LoadWeatherZoneChances(); });
+    loader.Add("quests", "objects", [] { sObjectMgr->LoadQuests(); }); // must be loaded after DBCs, creature_template, item_template, gameobject tables
+    loader.Add("quests relations", "objects", [] { sObjectMgr->LoadQuestRelations(); }); // must be after quest load
+    loader.Add("quests greetings", "objects", [] { sObjectMgr->LoadQuestGreetings(); }); // must be loaded after creature_template, gameobject_template tables
+    loader.Add("objects pooling data", "objects", [] { sPoolMgr->LoadFromDB(); }); // must be after quests
+    loader.Add("game event data", "objects", [] { sGameEventMgr->LoadFromDB(); }); // must be after quests
+    loader.Add("AreaTrigger definitions", "objects", [] { sObjectMgr->LoadAreaTriggerTeleports(); });
+    loader.Add("access requirements", "objects", [] { sObjectMgr->LoadAccessRequirements(); }); // must be after item template load
+    loader.Add("quest area triggers", "objects", [] { sObjectMgr->LoadQuestAreaTriggers(); }); // must be after LoadQuests
+    loader.Add("tavern area triggers", "objects", [] { sObjectMgr->LoadTavernAreaTriggers(); });
+    loader.Add("AreaTrigger script names", "objects", [] { sObjectMgr->LoadAreaTriggerScripts(); });
+    loader.Add("graveyard-zone links", "objects", [] { sObjectMgr->LoadGraveyardZones(); });
+    loader.Add("player create info & level stats", "objects", [] { sObjectMgr->LoadPlayerInfo(); });
+    loader.Add("exploration BaseXP data", "objects", [] { sObjectMgr->LoadExplorationBaseXP(); });
+    loader.Add("pet name parts", "objects", [] { sObjectMgr->LoadPetNames(); });
+    loader.Add("the max pet number", "objects", [] { sObjectMgr->LoadPetNumber(); });
+    loader.Add("pet level stats", "objects", [] { sObjectMgr->LoadPetLevelInfo(); });
+    loader.Add("disabled spells", "objects", [] { sObjectMgr->LoadSpellDisabledEntrys(); });
+    loader.Add("skill fishing base level requirements", "objects", [] { sObjectMgr->LoadFishingBaseSkillLevel(); });
+    loader.Add("BattleMasters", "objects", [] { sObjectMgr->LoadBattleMastersEntry(); });
+    loader.Add("BattleGround event indexes", "objects", [] { sBattlegroundMgr->LoadBattleEventIndexes(); });
+    loader.Add("GameTeleports", "objects", [] { sObjectMgr->LoadGameTele(); });
+    loader.Add("trainers", "objects", [] { sObjectMgr->LoadTrainers(); }); // must be after LoadCreatureTemplates
+    loader.Add("creature default trainers", "objects", [] { sObjectMgr->LoadCreatureDefaultTrainers(); });
+    loader.Add("npc gossip menus", "objects", [] { sObjectMgr->LoadGossipMenu(); });
+    loader.Add("npc options", "objects", [] { sObjectMgr->LoadGossipMenuItems(); }); // must be after LoadTrainers
+    loader.Add("vendors", "objects", [] { sObjectMgr->LoadVendors(); }); // must be after load CreatureTemplate and ItemTemplate
+    loader.Add("creature formations", "objects", [] { sFormationMgr->LoadCreatureFormations(); });
+
+    loader.Add("SpellArea data", "spells", { "quests" }, [] { sSpellMgr->LoadSpellAreas(); }); // must be after quest load
+
+    loader.Add("loot tables", "loot", { "quests" }, [] { LoadLootTables(); });
+    loader.Add("skill discovery table", "loot", [] { LoadSkillDiscoveryTable(); });
+    loader.Add("skill extra item table", "loot", [] { LoadSkillExtraItemTable(); });
+    loader.Add("GameObject for quests", "loot", [] { sObjectMgr->LoadGameObjectForQuests(); }); // must be after loot tables
+
+    loader.Add("world states", "characters", [this] { LoadWorldStates(); }); // must be loaded before battleground, outdoor PvP and conditions
     // sunwell: Global Storage, should be loaded asap
-    TC_LOG_INFO("server.loading", "Loading character cache store...");
-    sCharacterCache->LoadCharacterCacheStorage();
-
+    loader.Add("character cache store", "characters", [] { sCharacterCache->LoadCharacterCacheStorage(); });
     ///- Clean up and pack instances
-    // Must be called before `creature_respawn`/`gameobject_respawn` tables
-    TC_LOG_INFO("server.loading", "Loading instances..." );
-    sInstanceSaveMgr->LoadInstances();                              // must be called before `creature_respawn`/`gameobject_respawn` tables
-
-//    TC_LOG_INFO("server.loading", "Packing instances..." );
-//    sInstanceSaveMgr->PackInstances();
-
-    TC_LOG_INFO("server.loading", "Loading Broadcast texts...");
-    sObjectMgr->LoadBroadcastTexts();
-    sObjectMgr->LoadBroadcastTextLocales();
-
-    TC_LOG_INFO("server.loading", "Loading Localization strings..." );
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadItemLocales();
-    sObjectMgr->LoadQuestLocales();
-    sObjectMgr->LoadGossipTextLocales();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadQuestGreetingsLocales();
-    sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-
-    TC_LOG_INFO("server.loading", "Loading Page Texts..." );
-    sObjectMgr->LoadPageTexts();
-
-    TC_LOG_INFO("server.loading", "Loading Game Object Templates..." );   // must be after LoadPageTexts
-    sObjectMgr->LoadGameObjectTemplate();
-
-    TC_LOG_INFO("server.loading", "Loading NPC Texts..." );
-    sObjectMgr->LoadGossipText();
-
-    TC_LOG_INFO("server.loading", "Loading Enchant Spells Proc datas...");
-    sSpellMgr->LoadSpellEnchantProcData();
-
-    TC_LOG_INFO("server.loading", "Loading Item Random Enchantments Table..." );
-    LoadRandomEnchantmentsTable();
-
-    TC_LOG_INFO("server.loading", "Loading Items..." );                   // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr->LoadItemTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Model Based Info Data..." );
-    sObjectMgr->LoadCreatureModelInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Creature templates..." );
-    sObjectMgr->LoadCreatureTemplates(false);
-
-    TC_LOG_INFO("server.loading", "Loading Equipment templates...");
-    sObjectMgr->LoadEquipmentTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Creature template addons...");
-    sObjectMgr->LoadCreatureTemplateAddons();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Reputation OnKill Data..." );
-    sObjectMgr->LoadReputationOnKill();
-
-    TC_LOG_INFO("server.loading", "Loading Points Of Interest Data...");
-    sObjectMgr->LoadPointsOfInterest();
-
-    TC_LOG_INFO("server.loading", "Loading Pet Create Spells..." );
-    sObjectMgr->LoadPetCreateSpells();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Base Stats...");
-    sObjectMgr->LoadCreatureClassLevelStats();
-
-    TC_LOG_INFO("server.loading", "Loading Spawn Group Templates...");
-    sObjectMgr->LoadSpawnGroupTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading instance spawn groups...");
-    sObjectMgr->LoadInstanceSpawnGroups();
-
-    if(!getConfig(CONFIG_DEBUG_DISABLE_CREATURES_LOADING))
-    {
-        TC_LOG_INFO("server.loading", "Loading Creature Data..." );
-        sObjectMgr->LoadCreatures();
-
-        TC_LOG_INFO("server.loading", "Loading Creature Addon Data..." );
-        sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
-
-        TC_LOG_INFO("server.loading", "Loading Creature Movement Overrides...");
-        sObjectMgr->LoadCreatureMovementOverrides();                 // must be after LoadCreatures()
-    }
-
-    TC_LOG_INFO("server.loading", "Loading Temporary Summon Data...");
-    sObjectMgr->LoadTempSummons();                               // must be after LoadCreatureTemplates() and LoadGameObjectTemplates()
-
-    if (!getConfig(CONFIG_DEBUG_DISABLE_GAMEOBJECTS_LOADING))
-    {
-        TC_LOG_INFO("server.loading", "Loading Gameobject Data...");
-        sObjectMgr->LoadGameObjects();
-    }
-
-    TC_LOG_INFO("server.loading", "Loading Spawn Group Data...");
-    sObjectMgr->LoadSpawnGroups();
-
-    TC_LOG_INFO("server.loading", "Loading Transport templates...");
-    sTransportMgr->LoadTransportTemplates();
-
-    TC_LOG_INFO("server.loading", "Loading Weather Data..." );
-    sObjectMgr->LoadWeatherZoneChances();
-
-    TC_LOG_INFO("server.loading","Loading GameObject models...");
-    LoadGameObjectModelList(sWorld->GetDataPath());
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo diminishing infos...");
-    sSpellMgr->LoadSpellInfoDiminishing();
-
-    TC_LOG_INFO("server.loading", "Loading SpellInfo immunity infos...");
-    sSpellMgr->LoadSpellInfoImmunities();
-
-    TC_LOG_INFO("server.loading", "Loading Quests..." );
-    sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    TC_LOG_INFO("server.loading", "Loading Quests Relations..." );
-    sObjectMgr->LoadQuestRelations();                            // must be after quest load
-
-    TC_LOG_INFO("server.loading", "Loading Quests Greetings...");
-    sObjectMgr->LoadQuestGreetings();                           // must be loaded after creature_template, gameobject_template tables
-
-    TC_LOG_INFO("server.loading", "Loading Objects Pooling Data..."); //must be after quests
-    sPoolMgr->LoadFromDB(); 
-
-    TC_LOG_INFO("server.loading", "Loading Game Event Data..."); //must be after quests
-    sGameEventMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger definitions..." );
-    sObjectMgr->LoadAreaTriggerTeleports();
-
-    TC_LOG_INFO("server.loading", "Loading Access Requirements..." );
-    sObjectMgr->LoadAccessRequirements();                        // must be after item template load
-
-    TC_LOG_INFO("server.loading", "Loading Quest Area Triggers..." );
-    sObjectMgr->LoadQuestAreaTriggers();                         // must be after LoadQuests
-
-    TC_LOG_INFO("server.loading", "Loading SpellArea Data...");  // must be after quest load
-    sSpellMgr->LoadSpellAreas();
-
-    TC_LOG_INFO("server.loading", "Loading Tavern Area Triggers..." );
-    sObjectMgr->LoadTavernAreaTriggers();
-
-    TC_LOG_INFO("server.loading", "Loading AreaTrigger script names..." );
-    sObjectMgr->LoadAreaTriggerScripts();
-
-    TC_LOG_INFO("server.loading", "Loading Graveyard-zone links...");
-    sObjectMgr->LoadGraveyardZones();
-
-    TC_LOG_INFO("server.loading", "Loading Spell target coordinates..." );
-    sSpellMgr->LoadSpellTargetPositions();
-
-    TC_LOG_INFO("server.loading", "Loading SpellAffect definitions..." );
-    sSpellMgr->LoadSpellAffects(); 
-
-    TC_LOG_INFO("server.loading", "Loading linked spells...");
-    sSpellMgr->LoadSpellLinked();
-
-    TC_LOG_INFO("server.loading", "Loading Spell Proc conditions and data...");
-    sSpellMgr->LoadSpellProcs(); //must be after LoadSpellAffects 
-
-    TC_LOG_INFO("server.loading", "Loading spell pet auras..." );
-    sSpellMgr->LoadSpellPetAuras();
-
-    TC_LOG_INFO("server.loading","Overriding SpellItemEnchantment...");
-    sSpellMgr->OverrideSpellItemEnchantment();
-
-    TC_LOG_INFO("server.loading", "Loading player Create Info & Level Stats..." );
-    sObjectMgr->LoadPlayerInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Exploration BaseXP Data..." );
-    sObjectMgr->LoadExplorationBaseXP();
-
-    TC_LOG_INFO("server.loading", "Loading Pet Name Parts..." );
-    sObjectMgr->LoadPetNames();
-
-    TC_LOG_INFO("server.loading", "Loading the max pet number..." );
-    sObjectMgr->LoadPetNumber();
-
-    TC_LOG_INFO("server.loading", "Loading pet level stats..." );
-    sObjectMgr->LoadPetLevelInfo();
-
-    TC_LOG_INFO("server.loading", "Loading Disabled Spells..." );
-    sObjectMgr->LoadSpellDisabledEntrys();
-
-    TC_LOG_INFO("server.loading", "Loading Loot Tables..." );
-    LoadLootTables();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Discovery Table..." );
-    LoadSkillDiscoveryTable();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Extra Item Table..." );
-    LoadSkillExtraItemTable();
-
-    TC_LOG_INFO("server.loading", "Loading Skill Fishing base level requirements..." );
-    sObjectMgr->LoadFishingBaseSkillLevel();
-
-    ///- Load dynamic data tables from the database
-    TC_LOG_INFO("server.loading", "Loading Auctions..." );
-    sAuctionMgr->LoadAuctionItems();
-    sAuctionMgr->LoadAuctions();
-
-    TC_LOG_INFO("server.loading", "Loading Guilds..." );
-    sGuildMgr->LoadGuilds();
-
-    TC_LOG_INFO("server.loading", "Loading ArenaTeams..." );
-    sArenaTeamMgr->LoadArenaTeams();
-
-    TC_LOG_INFO("server.loading", "Loading Groups..." );
-    sGroupMgr->LoadGroups();
-
-    TC_LOG_INFO("server.loading", "Loading ReservedNames..." );
-    sObjectMgr->LoadReservedPlayersNames();
-
-    TC_LOG_INFO("server.loading", "Loading GameObject for quests..." );
-    sObjectMgr->LoadGameObjectForQuests();
-
-    TC_LOG_INFO("server.loading", "Loading BattleMasters..." );
-    sObjectMgr->LoadBattleMastersEntry();
-
-    TC_LOG_INFO("server.loading", "Loading BattleGround event indexes...");
-    sBattlegroundMgr->LoadBattleEventIndexes();
-
-    TC_LOG_INFO("server.loading", "Loading GameTeleports..." );
-    sObjectMgr->LoadGameTele();
-
-    TC_LOG_INFO("server.loading", "Loading Trainers...");       // must be after LoadCreatureTemplates
-    sObjectMgr->LoadTrainers();
-
-    TC_LOG_INFO("server.loading", "Loading Creature default trainers...");
-    sObjectMgr->LoadCreatureDefaultTrainers();
-
-    TC_LOG_INFO("server.loading", "Loading Npc gossip menus..." );
-    sObjectMgr->LoadGossipMenu();
-
-    TC_LOG_INFO("server.loading", "Loading Npc Options..." ); 
-    sObjectMgr->LoadGossipMenuItems();                       // must be after LoadTrainers
-
-    TC_LOG_INFO("server.loading", "Loading vendors..." );
-    sObjectMgr->LoadVendors();                                   // must be after load CreatureTemplate and ItemTemplate
-
-    TC_LOG_INFO("server.loading", "Loading Waypoints..." );
-    sWaypointMgr->Load();
-
-    TC_LOG_INFO("server.loading","Loading SmartAI Waypoints...");
-    sSmartWaypointMgr->LoadFromDB();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Formations..." );
-    sFormationMgr->LoadCreatureFormations();
-
-    TC_LOG_INFO("server.loading", "Loading World States...");              // must be loaded before battleground, outdoor PvP and conditions
-    LoadWorldStates();
-
-    TC_LOG_INFO("server.loading","Loading Conditions...");
-    sConditionMgr->LoadConditions();
-
-    TC_LOG_INFO("server.loading", "Loading client addons...");
-    AddonMgr::LoadFromDB();
-
+    loader.Add("instances", "characters", [] { sInstanceSaveMgr->LoadInstances(); }); // must be called before `creature_respawn`/`gameobject_respawn` tables
+    loader.Add("ReservedNames", "characters", [] { sObjectMgr->LoadReservedPlayersNames(); });
+    loader.Add("client addons", "characters", [] { AddonMgr::LoadFromDB(); });
+    loader.Add("GM tickets", "characters", [] { sTicketMgr->LoadTickets(); });
+    loader.Add("GM surveys", "characters", [] { sTicketMgr->LoadSurveys(); });
+    loader.Add("ArenaTeams", "characters", [] { sArenaTeamMgr->LoadArenaTeams(); });
+    loader.Add("groups", "characters", { "instance templates" }, [] { sGroupMgr->LoadGroups(); });
+    loader.Add("guilds", "characters", { "items" }, [] { sGuildMgr->LoadGuilds(); });
+    loader.Add("auctions", "characters", []
+    {
+        sAuctionMgr->LoadAuctionItems();
+        sAuctionMgr->LoadAuctions();
+    });
+    loader.Add("petitions", "characters", [] { sPetitionMgr->LoadPetitions(); });
+    loader.Add("signatures", "characters", [] { sPetitionMgr->LoadSignatures(); });
     ///- Handle outdated emails (delete/return)
-    TC_LOG_INFO("server.loading", "Returning old mails..." );
-    sObjectMgr->ReturnOrDeleteOldMails(false);
-
-    TC_LOG_INFO("server.loading","Loading faction change items...");
-    sObjectMgr->LoadFactionChangeItems();
-    TC_LOG_INFO("server.loading","Loading faction change spells...");
-    sObjectMgr->LoadFactionChangeSpells();
-    TC_LOG_INFO("server.loading","Loading faction change titles...");
-    sObjectMgr->LoadFactionChangeTitles();
-    TC_LOG_INFO("server.loading","Loading faction change quests...");
-    sObjectMgr->LoadFactionChangeQuests();
-    TC_LOG_INFO("server.loading","Loading faction change reputations (generic)...");
-    sObjectMgr->LoadFactionChangeReputGeneric();
-
-    TC_LOG_INFO("server.loading", "Loading GM tickets...");
-    sTicketMgr->LoadTickets();
-
-    TC_LOG_INFO("server.loading", "Loading GM surveys...");
-    sTicketMgr->LoadSurveys();
-
-    TC_LOG_INFO("server.loading", "Loading spell script names...");
-    sObjectMgr->LoadSpellScriptNames();
-
-    TC_LOG_INFO("server.loading","Loading Creature Texts...");
-    sCreatureTextMgr->LoadCreatureTexts();
-
-    TC_LOG_INFO("server.loading", "Loading Creature Text Locales...");
-    sCreatureTextMgr->LoadCreatureTextLocales();
-
+    loader.Add("old mails", "characters", [] { sObjectMgr->ReturnOrDeleteOldMails(false); });
+    loader.Add("item loot", "characters", { "loot tables" }, [] { sLootItemStorage->LoadStorageFromDB(); });
+
+    loader.Add("conditions", "objects", { "loot tables", "SpellArea data", "world states" }, [] { sConditionMgr->LoadConditions(); });
+    loader.Add("faction change tables", "objects", []
+    {
+        sObjectMgr->LoadFactionChangeItems();
+        sObjectMgr->LoadFactionChangeSpells();
+        sObjectMgr->LoadFactionChangeTitles();
+        sObjectMgr->LoadFactionChangeQuests();
+        sObjectMgr->LoadFactionChangeReputGeneric();
+    });
+    loader.Add("spell script names", "objects", [] { sObjectMgr->LoadSpellScriptNames(); });
+    loader.Add("creature texts", "objects", [] { sCreatureTextMgr->LoadCreatureTexts(); });
+    loader.Add("creature text locales", "objects", { "localization strings" }, [] { sCreatureTextMgr->LoadCreatureTextLocales(); });
     ///- Load and initialize scripts
-    TC_LOG_INFO("server.loading", "Loading Scripts..." );
-    sObjectMgr->LoadQuestStartScripts();                         // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sObjectMgr->LoadQuestEndScripts();                           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadGameObjectScripts();                         // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
-    sObjectMgr->LoadWaypointScripts();
-
-    TC_LOG_INFO("server.loading", "Initializing Scripts..." );
-    sScriptMgr->Initialize(_TRINITY_SCRIPT_CONFIG);
+    loader.Add("scripts", "objects", { "waypoints" }, []
+    {
+        sObjectMgr->LoadQuestStartScripts();                         // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sObjectMgr->LoadQuestEndScripts();                           // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sObjectMgr->LoadSpellScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadGameObjectScripts();                         // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadEventScripts();                              // must be after load Creature/Gameobject(Template/Data)
+        sObjectMgr->LoadWaypointScripts();
+    });
+    loader.Add("script manager", "objects", { "GameObject for quests", "skill extra item table" }, [] { sScriptMgr->Initialize(_TRINITY_SCRIPT_CONFIG); });
 //TC    sScriptMgr->OnConfigLoad(false);                                // must be done after the ScriptMgr has been properly initialized
+    loader.Add("spell scripts validation", "objects", [] { sObjectMgr->ValidateSpellScripts(); });
+    loader.Add("SmartAI scripts", "objects", { "SmartAI waypoints" }, [] { sSmartScriptMgr->LoadSmartAIFromDB(); });
 
-    TC_LOG_INFO("server.loading", "Validating spell scripts...");
-    sObjectMgr->ValidateSpellScripts();
-
-    TC_LOG_INFO("server.loading","Loading SmartAI scripts...");
-    sSmartScriptMgr->LoadSmartAIFromDB();
+    ///- Read the biggest world tables from the world database snapshot when they did not change since it was written
+    std::string const snapshotFile = sConfigMgr->GetStringDefault("Loading.SnapshotFile", "");
+    if (!snapshotFile.empty())
+        sWorldDatabaseSnapshot->Open(snapshotFile);
 
-    TC_LOG_INFO("server.loading", "Loading Petitions...");
-    sPetitionMgr->LoadPetitions();
+    loader.Run(getIntConfig(CONFIG_LOADING_THREADS));
 
-    TC_LOG_INFO("server.loading", "Loading Signatures...");
-    sPetitionMgr->LoadSignatures();
-
-    TC_LOG_INFO("server.loading", "Loading Item loot...");
-    sLootItemStorage->LoadStorageFromDB();
+    sWorldDatabaseSnapshot->Close();
 
     TC_LOG_INFO("server.loading", "Initialize query data...");
     sObjectMgr->InitializeQueriesData(QUERY_DATA_ALL);
@@ -1966,7 +1789,8 @@ void World::SetInitialWorldSettings()
     sLogsDatabaseAccessor->CleanupOldLogs();
 
     #ifdef PLAYERBOT
-    sPlayerbotAIConfig.Initialize();
+    if (sPlayerbotAIConfig.Initialize() && sPlayerbotAIConfig.thinkThreads)
+        sPlayerbotThinkPool.Activate(sPlayerbotAIConfig.thinkThreads);
     #endif
 
     if (sWorld->getBoolConfig(CONFIG_RESTORE_DELETED_ITEMS))
@@ -2034,6 +1858,8 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(time_t diff)
 {
+    TRACE_SCOPE("world", "World::Update");
+
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
     time_t currentGameTime = WorldGameTime::GetGameTime();
@@ -2276,6 +2102,7 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket const* packet, WorldSession *self, uint32 team)
 {
+    SharedWorldPacket sharedPacket = std::make_shared<WorldPacket const>(*packet);
     SessionMap::iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2285,7 +2112,7 @@ void World::SendGlobalMessage(WorldPacket const* packet, WorldSession *self, uin
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team) )
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(sharedPacket);
         }
     }
 }
@@ -2436,6 +2263,7 @@ void World::SendGlobalText(const char* text, WorldSession *self)
 /// Send a packet to all players (or players selected team) in the zone (except self if mentioned)
 void World::SendZoneMessage(uint32 zone, WorldPacket const* packet, WorldSession *self, uint32 team)
 {
+    SharedWorldPacket sharedPacket; // only copied once we found someone in the zone
     SessionMap::iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2446,7 +2274,10 @@ void World::SendZoneMessage(uint32 zone, WorldPacket const* packet, WorldSession
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team) )
         {
-            itr->second->SendPacket(packet);
+            if (!sharedPacket)
+                sharedPacket = std::make_shared<WorldPacket const>(*packet);
+
+            itr->second->SendPacket(sharedPacket);
         }
     }
 }
@@ -3214,6 +3045,7 @@ uint64 World::GetWorldState(uint32 index) const
 
 void World::ProcessQueryCallbacks()
 {
+    TRACE_SCOPE("db", "World::ProcessQueryCallbacks");
     _queryProcessor.ProcessReadyQueries();
 }
 
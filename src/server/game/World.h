@@ -82,6 +82,7 @@ enum WorldTimers
 enum WorldConfigs
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_IN_NETWORK_THREADS,
     CONFIG_GRID_UNLOAD,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_MAPUPDATE,
@@ -245,6 +246,11 @@ enum WorldConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PREMATURE_BG_REWARD,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_REGION_UPDATE,
+    CONFIG_MAP_REGION_UPDATE_THREADS,
+    CONFIG_MAP_REGION_UPDATE_MIN_PLAYERS,
+    CONFIG_GRID_PREFETCH_THREADS,
+    CONFIG_LOADING_THREADS,
 
     CONFIG_WORLDCHANNEL_MINLEVEL,
     CONFIG_TICKET_LEVEL_REQ,
@@ -0,0 +1,156 @@
+#include "WorldLoader.h"
+#include "Errors.h"
+#include "Log.h"
+#include "Timer.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+WorldLoader::WorldLoader() : _startTime(0), _remaining(0)
+{
+}
+
+void WorldLoader::Add(char const* name, char const* lane, std::initializer_list<char const*> dependencies, Step step)
+{
+    size_t const index = _steps.size();
+    bool const added = _stepsByName.emplace(name, index).second;
+    ASSERT(added, "WorldLoader: step '%s' was added twice", name);
+
+    StepInfo info;
+    info.name = name;
+    info.step = std::move(step);
+
+    auto addDependency = [&](size_t dependency)
+    {
+        if (std::find(info.dependencies.begin(), info.dependencies.end(), dependency) != info.dependencies.end())
+            return;
+
+        info.dependencies.push_back(dependency);
+        _steps[dependency].dependents.push_back(index);
+    };
+
+    auto previous = _lastStepByLane.find(lane);
+    if (previous != _lastStepByLane.end())
+    {
+        addDependency(previous->second);
+        previous->second = index;
+    }
+    else
+        _lastStepByLane[lane] = index;
+
+    for (char const* dependency : dependencies)
+    {
+        auto itr = _stepsByName.find(dependency);
+        ASSERT(itr != _stepsByName.end() && itr->second != index, "WorldLoader: step '%s' depends on '%s' which wasn't added before it", name, dependency);
+        addDependency(itr->second);
+    }
+
+    info.pendingDependencies = uint32(info.dependencies.size());
+    _steps.push_back(std::move(info));
+}
+
+void WorldLoader::Run(uint32 threads)
+{
+    _startTime = GetMSTime();
+
+    if (threads <= 1)
+    {
+        // dependencies are always added before their dependents, so this order satisfies them all
+        for (size_t i = 0; i < _steps.size(); ++i)
+            RunStep(i);
+    }
+    else
+    {
+        _remaining = _steps.size();
+        for (size_t i = 0; i < _steps.size(); ++i)
+            if (!_steps[i].pendingDependencies)
+                _ready.insert(i);
+
+        std::vector<std::thread> workers;
+        for (uint32 i = 1; i < threads; ++i)
+            workers.push_back(std::thread(&WorldLoader::WorkerThread, this));
+
+        WorkerThread();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    LogReport(threads, GetMSTimeDiffToNow(_startTime));
+}
+
+void WorldLoader::RunStep(size_t index)
+{
+    StepInfo& info = _steps[index];
+
+    TC_LOG_INFO("server.loading", "Loading %s...", info.name.c_str());
+    info.startTime = GetMSTimeDiffToNow(_startTime);
+    info.step();
+    info.duration = GetMSTimeDiffToNow(_startTime) - info.startTime;
+}
+
+void WorldLoader::WorkerThread()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_remaining)
+    {
+        if (_ready.empty())
+        {
+            _condition.wait(lock);
+            continue;
+        }
+
+        size_t const index = *_ready.begin();
+        _ready.erase(_ready.begin());
+
+        lock.unlock();
+        RunStep(index);
+        lock.lock();
+
+        --_remaining;
+        for (size_t dependent : _steps[index].dependents)
+            if (!--_steps[dependent].pendingDependencies)
+                _ready.insert(dependent);
+
+        _condition.notify_all();
+    }
+}
+
+void WorldLoader::LogReport(uint32 threads, uint32 totalTime) const
+{
+    if (_steps.empty())
+        return;
+
+    // longest chain of steps ending with each step. Dependencies are added first so they are always computed first.
+    size_t const none = std::numeric_limits<size_t>::max();
+    std::vector<uint32> pathTime(_steps.size(), 0);
+    std::vector<size_t> pathPrevious(_steps.size(), none);
+    uint32 stepsTime = 0;
+    size_t last = 0;
+    for (size_t i = 0; i < _steps.size(); ++i)
+    {
+        for (size_t dependency : _steps[i].dependencies)
+        {
+            if (pathPrevious[i] == none || pathTime[dependency] > pathTime[pathPrevious[i]])
+                pathPrevious[i] = dependency;
+        }
+
+        pathTime[i] = _steps[i].duration + (pathPrevious[i] != none ? pathTime[pathPrevious[i]] : 0);
+        stepsTime += _steps[i].duration;
+        if (pathTime[i] > pathTime[last])
+            last = i;
+    }
+
+    std::vector<size_t> criticalPath;
+    for (size_t i = last; i != none; i = pathPrevious[i])
+        criticalPath.push_back(i);
+
+    TC_LOG_INFO("server.loading", ">> Ran %u loading steps in %u ms with %u thread(s), %u ms of steps time. Critical path is %u ms:",
+        uint32(_steps.size()), totalTime, std::max(threads, 1u), stepsTime, pathTime[last]);
+
+    for (auto itr = criticalPath.rbegin(); itr != criticalPath.rend(); ++itr)
+    {
+        StepInfo const& info = _steps[*itr];
+        TC_LOG_INFO("server.loading", "    %6u ms (started at %6u ms) %s", info.duration, info.startTime, info.name.c_str());
+    }
+}
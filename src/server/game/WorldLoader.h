@@ -0,0 +1,64 @@
+
+#ifndef _WORLD_LOADER_H_INCLUDED
+#define _WORLD_LOADER_H_INCLUDED
+
+#include "Define.h"
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+Runs the world startup loaders (see World::SetInitialWorldSettings) as a dependency graph:
+- Each step belongs to a lane, steps of a lane run one after the other in the order they were added.
+  Lanes are meant to group loaders filling the same containers (spells, objects templates and spawns, characters db data...)
+- A step can also depend on steps from other lanes, by name. Dependencies must be added before the step depending on them.
+- Ready steps are run on a thread pool, so that one lane processing its results overlaps with another lane waiting for the DB.
+With a single thread, steps simply run in the order they were added.
+Once done, the time spent in each step is used to log the critical path, the chain of steps bounding the loading time.
+*/
+class WorldLoader
+{
+public:
+    typedef std::function<void()> Step;
+
+    WorldLoader();
+
+    void Add(char const* name, char const* lane, std::initializer_list<char const*> dependencies, Step step);
+    void Add(char const* name, char const* lane, Step step) { Add(name, lane, {}, std::move(step)); }
+
+    // Run all steps with given number of threads (the calling thread included), 0 or 1 to run them all on the calling thread
+    void Run(uint32 threads);
+
+private:
+    struct StepInfo
+    {
+        std::string name;
+        Step step;
+        std::vector<size_t> dependencies;
+        std::vector<size_t> dependents;
+        uint32 pendingDependencies = 0;
+        uint32 startTime = 0; // ms since loading start
+        uint32 duration = 0;
+    };
+
+    void RunStep(size_t index);
+    void WorkerThread();
+    void LogReport(uint32 threads, uint32 totalTime) const;
+
+    std::vector<StepInfo> _steps;
+    std::unordered_map<std::string, size_t> _stepsByName;
+    std::unordered_map<std::string, size_t> _lastStepByLane;
+    uint32 _startTime;
+
+    std::mutex _lock;
+    std::condition_variable _condition;
+    std::set<size_t> _ready; // ordered, so that steps added first are started first
+    size_t _remaining;
+};
+
+#endif //_WORLD_LOADER_H_INCLUDED
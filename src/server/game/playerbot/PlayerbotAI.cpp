@@ -15,6 +15,7 @@
 #include "PlayerbotAI.h"
 #include "PlayerbotFactory.h"
 #include "PlayerbotSecurity.h"
+#include "PlayerbotThinkPool.h"
 #include "Group.h"
 #include "Pet.h"
 #include "SpellAuras.h"
@@ -62,14 +63,14 @@ void PacketHandlingHelper::AddPacket(const WorldPacket& packet)
 
 
 PlayerbotAI::PlayerbotAI() : PlayerbotAIBase(), bot(nullptr), aiObjectContext(nullptr),
-    currentEngine(nullptr), chatHelper(this), chatFilter(this), accountId(0), security(nullptr), master(nullptr), currentState(BOT_STATE_NON_COMBAT)
+    currentEngine(nullptr), thinkingEngine(nullptr), chatHelper(this), chatFilter(this), accountId(0), security(nullptr), master(nullptr), currentState(BOT_STATE_NON_COMBAT)
 {
     for (int i = 0 ; i < BOT_STATE_MAX; i++)
         engines[i] = nullptr;
 }
 
 PlayerbotAI::PlayerbotAI(Player* bot) :
-    PlayerbotAIBase(), chatHelper(this), chatFilter(this), security(bot), master(nullptr)
+    PlayerbotAIBase(), thinkingEngine(nullptr), chatHelper(this), chatFilter(this), security(bot), master(nullptr)
 {
     this->bot = bot;
 
@@ -142,7 +143,10 @@ PlayerbotAI::~PlayerbotAI()
 void PlayerbotAI::UpdateAI(uint32 elapsed)
 {
     if (bot->IsBeingTeleported())
+    {
+        thinkingEngine = nullptr;
         return;
+    }
 
     if (nextAICheckDelay > sPlayerbotAIConfig.globalCoolDown &&
             bot->IsNonMeleeSpellCast(true, true, false) &&
@@ -162,6 +166,24 @@ void PlayerbotAI::UpdateAI(uint32 elapsed)
     }
 
     PlayerbotAIBase::UpdateAI(elapsed);
+
+    // what was evaluated is only valid for this update
+    thinkingEngine = nullptr;
+}
+
+bool PlayerbotAI::IsThinkDue(uint32 elapsed)
+{
+    if (bot->IsBeingTeleported() || (GetMaster() && GetMaster()->IsBeingTeleported()))
+        return false;
+
+    // same as CanUpdateAI once PlayerbotAIBase::UpdateAI has consumed elapsed
+    return nextAICheckDelay < elapsed + 100;
+}
+
+void PlayerbotAI::Think()
+{
+    currentEngine->PrepareNextAction();
+    thinkingEngine = currentEngine;
 }
 
 
@@ -186,6 +208,10 @@ void PlayerbotAI::UpdateAIInternal(uint32 elapsed)
     masterIncomingPacketHandlers.Handle(helper);
     masterOutgoingPacketHandlers.Handle(helper);
 
+    // events delivered since Think were not seen by its triggers check
+    if (currentEngine == thinkingEngine && !helper.GetTriggered().empty())
+        currentEngine->ProcessExternalTriggers(helper.GetTriggered());
+
     DoNextAction();
 }
 
@@ -327,45 +353,30 @@ void PlayerbotAI::HandleBotOutgoingPacket(const WorldPacket& packet)
             botOutgoingPacketHandlers.AddPacket(packet);
             return;
         }
-    case SMSG_SPELL_FAILURE:
-        { //BC + LK okay
-            WorldPacket p(packet);
-            p.rpos(0);
-            ObjectGuid casterGuid;
-            p >> casterGuid.ReadAsPacked();
-            if (casterGuid != bot->GetGUID())
-                return;
-
-            uint32 spellId;
-#ifdef LICH_KING
-            uint8 castCount;
-            p >> castCount;
-#endif
-            p >> spellId;
-            SpellInterrupted(spellId);
-            return;
-        }
-    case SMSG_SPELL_DELAYED:
-        { //BC + LK okay
-            WorldPacket p(packet);
-            p.rpos(0);
-            ObjectGuid casterGuid;
-            p >> casterGuid.ReadAsPacked();
-
-            if (casterGuid != bot->GetGUID())
-                return;
-
-            uint32 delaytime;
-            p >> delaytime;
-            if (delaytime <= 1000)
-                IncreaseNextCheckDelay(delaytime);
-            return;
-        }
+    // SMSG_SPELL_FAILURE and SMSG_SPELL_DELAYED are not sent to bots, Spell calls SpellInterrupted and SpellDelayed directly
     default:
         botOutgoingPacketHandlers.AddPacket(packet);
     }
 }
 
+bool PlayerbotAI::IsOutgoingPacketHandled(uint16 opcode) const
+{
+    switch (opcode)
+    {
+    case SMSG_MOVE_SET_CAN_FLY:
+    case SMSG_MOVE_UNSET_CAN_FLY:
+        return true;
+    default:
+        return botOutgoingPacketHandlers.HasHandler(opcode);
+    }
+}
+
+void PlayerbotAI::SpellDelayed(uint32 delayTime)
+{
+    if (delayTime <= 1000)
+        IncreaseNextCheckDelay(delayTime);
+}
+
 void PlayerbotAI::SpellInterrupted(uint32 spellid)
 {
     LastSpellCast& lastSpell = aiObjectContext->GetValue<LastSpellCast&>("last spell cast")->Get();
@@ -442,7 +453,9 @@ void PlayerbotAI::DoNextAction()
     if (bot->IsBeingTeleported() || (GetMaster() && GetMaster()->IsBeingTeleported()))
         return;
 
-    currentEngine->DoNextAction(NULL);
+    // engine may have changed since Think, from chat commands or packets handled in between
+    currentEngine->DoNextAction(NULL, 0, currentEngine == thinkingEngine);
+    thinkingEngine = nullptr;
 
     if (bot->HasAuraType(SPELL_AURA_MOD_INCREASE_MOUNTED_FLIGHT_SPEED))
     {
@@ -848,6 +861,11 @@ bool PlayerbotAI::CanCastSpell(uint32 spellid, Unit* target, bool checkHasSpell)
     if (bot != target && bot->GetDistance(target) > sPlayerbotAIConfig.sightDistance)
         return false;
 
+    // The cast check changes the bot selection and builds a spell, which can't be done while other bots think in parallel.
+    // Triggers only get the checks above then, actions check again from the map thread before casting.
+    if (PlayerbotThinkPool::IsThinking())
+        return true;
+
     Unit* oldSel = bot->GetSelectedUnit();
     bot->SetSelection(target->GetGUID());
     Spell *spell = new Spell(bot, spellInfo, TRIGGERED_NONE);
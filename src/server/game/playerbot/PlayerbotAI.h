@@ -70,6 +70,7 @@ class PacketHandlingHelper
 {
 public:
     void AddHandler(uint16 opcode, std::string handler);
+    bool HasHandler(uint16 opcode) const { return handlers.find(opcode) != handlers.end(); }
     void Handle(ExternalEventHelper &helper);
     void AddPacket(const WorldPacket& packet);
 
@@ -107,10 +108,16 @@ public:
     string HandleRemoteCommand(std::string command);
     void HandleCommand(uint32 type, const std::string& text, Player& fromPlayer);
     void HandleBotOutgoingPacket(const WorldPacket& packet);
+    /// Whether HandleBotOutgoingPacket does anything with this opcode. Bot sessions have no client, other packets don't need to be built for them.
+    bool IsOutgoingPacketHandled(uint16 opcode) const;
     void HandleMasterIncomingPacket(const WorldPacket& packet);
     void HandleMasterOutgoingPacket(const WorldPacket& packet);
     void HandleTeleportAck();
     void ChangeEngine(BotState type);
+    /// Whether the next UpdateAI call with given elapsed time will pick an action, and the triggers can be evaluated ahead with Think
+    virtual bool IsThinkDue(uint32 elapsed);
+    /// Update values and evaluate triggers of the current engine. Only reads the world, may be called from PlayerbotThinkPool workers.
+    void Think();
     void DoNextAction();
     void DoSpecificAction(std::string name);
     void ChangeStrategy(std::string name, BotState type);
@@ -129,6 +136,8 @@ public:
     bool TellMaster(std::string text, PlayerbotSecurityLevel securityLevel = PLAYERBOT_SECURITY_ALLOW_ALL);
     bool TellMasterNoFacing(std::string text, PlayerbotSecurityLevel securityLevel = PLAYERBOT_SECURITY_ALLOW_ALL);
     void SpellInterrupted(uint32 spellid);
+    /// Our cast has been pushed back, called directly by Spell::Delayed instead of going through SMSG_SPELL_DELAYED
+    void SpellDelayed(uint32 delayTime);
     int32 CalculateGlobalCooldown(uint32 spellid);
     void InterruptSpell();
     void RemoveAura(std::string name);
@@ -179,6 +188,7 @@ protected:
     uint32 accountId;
     AiObjectContext* aiObjectContext;
     Engine* currentEngine;
+    Engine* thinkingEngine; // engine that already evaluated its triggers for the coming action, if any
     Engine* engines[BOT_STATE_MAX];
     BotState currentState;
     ChatHelper chatHelper;
@@ -197,6 +207,7 @@ public:
     virtual ~PlayerbotTestingAI() {}
 
     void UpdateAIInternal(uint32 elapsed) override;
+    bool IsThinkDue(uint32 elapsed) override { return false; }
     virtual void CastedDamageSpell(Unit const* target, SpellNonMeleeDamage damageInfo, SpellMissInfo missInfo, bool crit) const override;
     virtual void CastedHealingSpell(Unit const* target, uint32 healing, uint32 realGain, uint32 spellID, SpellMissInfo missInfo, bool crit) const override;
     virtual void PeriodicTick(Unit const* target, int32 amount, uint32 spellID) const override;
@@ -73,6 +73,8 @@ bool PlayerbotAIConfig::Initialize()
     randomBotMaxLevelChance = config.GetFloatDefault("AiPlayerbot.RandomBotMaxLevelChance", 0.4);
 
     iterationsPerTick = config.GetIntDefault("AiPlayerbot.IterationsPerTick", 4);
+    // not in the shipped config: values still visit grids and check LOS from the think threads, see PlayerbotThinkPool
+    thinkThreads = config.GetIntDefault("AiPlayerbot.ThinkThreads", 0);
 
     allowGuildBots = config.GetBoolDefault("AiPlayerbot.AllowGuildBots", true);
 
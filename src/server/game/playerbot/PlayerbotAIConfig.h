@@ -69,6 +69,7 @@ public:
     uint32 minGuildTaskRewardTime, maxGuildTaskRewardTime;
 
     uint32 iterationsPerTick;
+    uint32 thinkThreads;
 
     int commandServerPort;
 
@@ -0,0 +1,72 @@
+#include "playerbot.h"
+#include "PlayerbotThinkPool.h"
+#include "Tracing.h"
+
+static thread_local bool thinking = false;
+
+PlayerbotThinkPool::~PlayerbotThinkPool()
+{
+    if (IsActive())
+        Deactivate();
+}
+
+void PlayerbotThinkPool::Activate(uint32 numThreads)
+{
+    if (IsActive())
+        return;
+
+    _cancelationToken = false;
+    for (uint32 i = 0; i < numThreads; ++i)
+        _threads.push_back(std::thread(&PlayerbotThinkPool::WorkerThread, this));
+
+    sLog->outMessage("playerbot", LOG_LEVEL_INFO, "Bots will think using %u threads", numThreads);
+}
+
+void PlayerbotThinkPool::Deactivate()
+{
+    _cancelationToken = true;
+    _queue.Cancel();
+
+    for (auto& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+}
+
+void PlayerbotThinkPool::Think(std::vector<PlayerbotAI*> const& bots)
+{
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(bots.size());
+    for (PlayerbotAI* bot : bots)
+        tasks.push_back([bot]()
+        {
+            thinking = true;
+            bot->Think();
+            thinking = false;
+        });
+
+    TaskBatch::Run(_queue, _threads.size(), std::move(tasks));
+}
+
+bool PlayerbotThinkPool::IsThinking()
+{
+    return thinking;
+}
+
+void PlayerbotThinkPool::WorkerThread()
+{
+    sTracing->SetThreadName("Playerbot think");
+
+    while (1)
+    {
+        TaskBatch::Ptr batch;
+
+        _queue.WaitAndPop(batch);
+
+        if (_cancelationToken)
+            return;
+
+        if (batch)
+            batch->Work();
+    }
+}
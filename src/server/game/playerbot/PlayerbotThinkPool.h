@@ -0,0 +1,55 @@
+#ifndef _PlayerbotThinkPool_H
+#define _PlayerbotThinkPool_H
+
+#include "Common.h"
+#include "ProducerConsumerQueue.h"
+#include "TaskBatch.h"
+#include <atomic>
+#include <thread>
+
+class PlayerbotAI;
+
+/*
+Bots decision making is split in two:
+- Think: values update and triggers evaluation, which fill the engine action queue
+- Act: picking and executing actions from that queue, done as usual from Player::Update on the map thread
+
+When enabled, each map lets its due bots think in parallel on this pool right before updating its players, see Map::UpdatePlayerbotsThinking.
+The map thread waits for them and helps meanwhile, so the world is not changing under the bots while they think.
+Thinking must then not change the world: code reached from triggers and values checks IsThinking() to skip what would (see PlayerbotAI::CanCastSpell).
+Values visiting grids or checking LOS were not all reviewed for this yet, hence AiPlayerbot.ThinkThreads is left out of the shipped config.
+*/
+class TC_GAME_API PlayerbotThinkPool
+{
+public:
+    static PlayerbotThinkPool& instance()
+    {
+        static PlayerbotThinkPool instance;
+        return instance;
+    }
+
+    ~PlayerbotThinkPool();
+
+    void Activate(uint32 numThreads);
+    void Deactivate();
+    bool IsActive() const { return !_threads.empty(); }
+
+    // Let given bots think. The calling thread takes part in the work, and this returns once all bots are done.
+    void Think(std::vector<PlayerbotAI*> const& bots);
+
+    // Whether the calling thread is currently letting a bot think in parallel of others
+    static bool IsThinking();
+
+private:
+    PlayerbotThinkPool() : _cancelationToken(false) {}
+
+    void WorkerThread();
+
+    std::vector<std::thread> _threads;
+    ProducerConsumerQueue<TaskBatch::Ptr> _queue;
+    std::atomic<bool> _cancelationToken;
+};
+
+#define sPlayerbotThinkPool PlayerbotThinkPool::instance()
+
+#endif
@@ -13,7 +13,7 @@
 #include "TestPlayer.h"
 #endif
 
-RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0)
+RandomPlayerbotMgr::RandomPlayerbotMgr() : PlayerbotHolder(), processTicks(0), eventValuesLoaded(false), creatureSpawnPositionsLoaded(false)
 {
 }
 
@@ -21,6 +21,14 @@ RandomPlayerbotMgr::~RandomPlayerbotMgr()
 {
 }
 
+void RandomPlayerbotMgr::UpdateAI(uint32 elapsed)
+{
+    PlayerbotHolder::UpdateAI(elapsed);
+
+    // values changed this tick, from bots processing or from bots trading and looting
+    FlushEventValues();
+}
+
 void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed)
 {
     SetNextCheckDelay(sPlayerbotAIConfig.randomBotUpdateInterval * 1000);
@@ -262,62 +270,48 @@ void RandomPlayerbotMgr::RandomTeleport(Player* bot, vector<WorldLocation> &locs
 
 void RandomPlayerbotMgr::RandomTeleportForLevel(Player* bot)
 {
+    LoadCreatureSpawnPositions();
+
+    // Creatures around bot level, excluding the ones in sight of much lower level creatures
+    float const botLevel = float(bot->GetLevel());
+    float const teleLevel = float(sPlayerbotAIConfig.randomBotTeleLevel);
+    float const sightDistance = sPlayerbotAIConfig.sightDistance;
+
     vector<WorldLocation> locs;
-    // Select positions from creatures in bot level range AND in specified maps (sPlayerbotAIConfig.randomBotMapsAsString) AND 
-    QueryResult results = WorldDatabase.PQuery(
-        "SELECT map, position_x, position_y, position_z "
-        "FROM "
-        "("
-            //                                                                                 bot->GetLevel()
-            "SELECT map, position_x, position_y, position_z, avg(t.maxlevel), avg(t.minlevel), (%u - (avg(t.maxlevel) + avg(t.minlevel)) / 2) AS delta "
-            "FROM creature c "
-            "JOIN creature_entry ce ON ce.spawnID = c.spawnID "
-            "INNER JOIN creature_template t ON ce.entry = t.entry "
-            "GROUP BY t.entry "
-        ") q "
-        "WHERE delta >= 0 "
-        "AND delta <= %u " //randomBotTeleLevel
-        "AND map IN (%s) " //randomBotMapsAsString
-        "AND NOT EXISTS "
-        "( "
-            "SELECT map, position_x, position_y, position_z "
-            "FROM "
-            "("
-                //                                                                               bot->GetLevel()
-               "SELECT map, c.position_x, c.position_y, c.position_z, avg(t.maxlevel), avg(t.minlevel), (%u - (avg(t.maxlevel) + avg(t.minlevel)) / 2) AS delta "
-                "FROM creature c "
-                "JOIN creature_entry ce ON ce.spawnID = c.spawnID "
-                "INNER JOIN creature_template t on ce.entry = t.entry "
-                "GROUP BY t.entry "
-            ") q1 "
-            //     randomBotTeleLevel
-            "WHERE delta > %u and q1.map = q.map "
-            "AND sqrt("
-                "(q1.position_x - q.position_x)*(q1.position_x - q.position_x) +"
-                "(q1.position_y - q.position_y)*(q1.position_y - q.position_y) +"
-                "(q1.position_z - q.position_z)*(q1.position_z - q.position_z)"
-                // sightDistance
-                ") < %f"
-        ")",
-        bot->GetLevel(),
-        sPlayerbotAIConfig.randomBotTeleLevel,
-        sPlayerbotAIConfig.randomBotMapsAsString.c_str(),
-        bot->GetLevel(),
-        sPlayerbotAIConfig.randomBotTeleLevel,
-        sPlayerbotAIConfig.sightDistance
-        );
-    if (results)
+    std::vector<CreatureSpawnPosition const*> nearby;
+    for (uint32 mapId : sPlayerbotAIConfig.randomBotMaps)
     {
-        do
+        auto itr = creatureSpawnPositions.find(mapId);
+        if (itr == creatureSpawnPositions.end())
+            continue;
+
+        for (CreatureSpawnPosition const& spawn : itr->second)
         {
-            Field* fields = results->Fetch();
-            uint16 mapId = fields[0].GetUInt16();
-            float x = fields[1].GetFloat();
-            float y = fields[2].GetFloat();
-            float z = fields[3].GetFloat();
-            WorldLocation loc(mapId, x, y, z, 0);
-            locs.push_back(loc);
-        } while (results->NextRow());
+            float const delta = botLevel - spawn.GetLevel();
+            if (delta < 0.0f || delta > teleLevel)
+                continue;
+
+            nearby.clear();
+            GetCreatureSpawnPositions(mapId, spawn.x, spawn.y, sightDistance, nearby);
+            bool lowLevelInSight = false;
+            for (CreatureSpawnPosition const* other : nearby)
+            {
+                if (botLevel - other->GetLevel() <= teleLevel)
+                    continue;
+
+                float const dx = other->x - spawn.x;
+                float const dy = other->y - spawn.y;
+                float const dz = other->z - spawn.z;
+                if (dx * dx + dy * dy + dz * dz < sightDistance * sightDistance)
+                {
+                    lowLevelInSight = true;
+                    break;
+                }
+            }
+
+            if (!lowLevelInSight)
+                locs.push_back(WorldLocation(mapId, spawn.x, spawn.y, spawn.z, 0));
+        }
     }
 
     RandomTeleport(bot, locs);
@@ -325,26 +319,60 @@ void RandomPlayerbotMgr::RandomTeleportForLevel(Player* bot)
 
 void RandomPlayerbotMgr::RandomTeleport(Player* bot, uint16 mapId, float teleX, float teleY, float teleZ)
 {
+    LoadCreatureSpawnPositions();
+
     vector<WorldLocation> locs;
-    QueryResult results = WorldDatabase.PQuery("select position_x, position_y, position_z from creature where map = '%u' and abs(position_x - '%f') < '%u' and abs(position_y - '%f') < '%u'",
-            mapId, teleX, sPlayerbotAIConfig.randomBotTeleportDistance / 2, teleY, sPlayerbotAIConfig.randomBotTeleportDistance / 2);
-    if (results)
-    {
-        do
-        {
-            Field* fields = results->Fetch();
-            float x = fields[0].GetFloat();
-            float y = fields[1].GetFloat();
-            float z = fields[2].GetFloat();
-            WorldLocation loc(mapId, x, y, z, 0);
-            locs.push_back(loc);
-        } while (results->NextRow());
-    }
+    std::vector<CreatureSpawnPosition const*> positions;
+    GetCreatureSpawnPositions(mapId, teleX, teleY, sPlayerbotAIConfig.randomBotTeleportDistance / 2, positions);
+    for (CreatureSpawnPosition const* spawn : positions)
+        locs.push_back(WorldLocation(mapId, spawn->x, spawn->y, spawn->z, 0));
 
     RandomTeleport(bot, locs);
     Refresh(bot);
 }
 
+void RandomPlayerbotMgr::LoadCreatureSpawnPositions()
+{
+    if (creatureSpawnPositionsLoaded)
+        return;
+
+    creatureSpawnPositionsLoaded = true;
+    for (auto const& itr : sObjectMgr->GetAllCreatureData())
+    {
+        CreatureData const& data = itr.second;
+        if (data.ids.empty())
+            continue;
+
+        CreatureTemplate const* cInfo = sObjectMgr->GetCreatureTemplate(data.GetFirstSpawnEntry());
+        if (!cInfo)
+            continue;
+
+        CreatureSpawnPosition position;
+        position.x = data.spawnPoint.GetPositionX();
+        position.y = data.spawnPoint.GetPositionY();
+        position.z = data.spawnPoint.GetPositionZ();
+        position.minLevel = uint8(cInfo->minlevel);
+        position.maxLevel = uint8(cInfo->maxlevel);
+        creatureSpawnPositions[data.spawnPoint.GetMapId()].push_back(position);
+    }
+
+    for (auto& itr : creatureSpawnPositions)
+        std::sort(itr.second.begin(), itr.second.end(), [](CreatureSpawnPosition const& a, CreatureSpawnPosition const& b) { return a.x < b.x; });
+}
+
+void RandomPlayerbotMgr::GetCreatureSpawnPositions(uint32 mapId, float x, float y, float range, std::vector<CreatureSpawnPosition const*>& positions)
+{
+    auto itr = creatureSpawnPositions.find(mapId);
+    if (itr == creatureSpawnPositions.end())
+        return;
+
+    CreatureSpawnPositions const& spawns = itr->second;
+    auto spawn = std::lower_bound(spawns.begin(), spawns.end(), x - range, [](CreatureSpawnPosition const& a, float value) { return a.x < value; });
+    for (; spawn != spawns.end() && spawn->x < x + range; ++spawn)
+        if (std::fabs(spawn->y - y) < range)
+            positions.push_back(&*spawn);
+}
+
 void RandomPlayerbotMgr::Randomize(Player* bot)
 {
     if (bot->GetLevel() == 1)
@@ -411,17 +439,27 @@ uint32 RandomPlayerbotMgr::GetZoneLevel(uint16 mapId, float teleX, float teleY,
 {
     uint32 maxLevel = sWorld->getIntConfig(CONFIG_MAX_PLAYER_LEVEL);
 
-    uint32 level;
-    QueryResult results = WorldDatabase.PQuery("select avg(t.minlevel) minlevel, avg(t.maxlevel) maxlevel from creature c "
-            "inner join creature_template t on c.id = t.entry "
-            "where map = '%u' and minlevel > 1 and abs(position_x - '%f') < '%u' and abs(position_y - '%f') < '%u'",
-            mapId, teleX, sPlayerbotAIConfig.randomBotTeleportDistance / 2, teleY, sPlayerbotAIConfig.randomBotTeleportDistance / 2);
+    LoadCreatureSpawnPositions();
+
+    std::vector<CreatureSpawnPosition const*> positions;
+    GetCreatureSpawnPositions(mapId, teleX, teleY, sPlayerbotAIConfig.randomBotTeleportDistance / 2, positions);
 
-    if (results)
+    uint32 minLevelSum = 0, maxLevelSum = 0, count = 0;
+    for (CreatureSpawnPosition const* spawn : positions)
     {
-        Field* fields = results->Fetch();
-        uint8 zoneMinLevel = uint8(fields[0].GetDouble());
-        uint8 zoneMaxLevel = uint8(fields[1].GetDouble());
+        if (spawn->minLevel <= 1)
+            continue;
+
+        minLevelSum += spawn->minLevel;
+        maxLevelSum += spawn->maxLevel;
+        ++count;
+    }
+
+    uint32 level;
+    if (count)
+    {
+        uint8 zoneMinLevel = uint8(minLevelSum / count);
+        uint8 zoneMaxLevel = uint8(maxLevelSum / count);
         level = urand(zoneMinLevel, zoneMaxLevel);
         if (level > zoneMaxLevel)
             level = zoneMaxLevel;
@@ -476,18 +514,13 @@ bool RandomPlayerbotMgr::IsRandomBot(uint32 bot)
 std::list<uint32> RandomPlayerbotMgr::GetBots()
 {
     list<uint32> bots;
-
-    QueryResult results = CharacterDatabase.Query(
-            "select bot from ai_playerbot_random_bots where owner = 0 and event = 'add'");
-
-    if (results)
     {
-        do
-        {
-            Field* fields = results->Fetch();
-            uint32 bot = uint32(fields[0].GetUInt64());
-            bots.push_back(bot);
-        } while (results->NextRow());
+        std::lock_guard<std::mutex> lock(eventValuesLock);
+        LoadEventValues();
+
+        for (auto const& itr : eventValues)
+            if (itr.second.find("add") != itr.second.end())
+                bots.push_back(itr.first);
     }
 
     //add data to player global data if not existing yet
@@ -496,8 +529,9 @@ std::list<uint32> RandomPlayerbotMgr::GetBots()
         auto data = sCharacterCache->GetCharacterCacheByGuid(itr);
         if (!data)
         {
-            QueryResult results2 = CharacterDatabase.PQuery("select account, name, gender, race, class, level FROM characters where guid = %u", itr);
-            if (results2)
+            PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_PLAYERBOT_CHAR_CACHE_INFO);
+            stmt->setUInt32(0, itr);
+            if (PreparedQueryResult results2 = CharacterDatabase.Query(stmt))
             {
                 Field* fields = results2->Fetch();
                 uint32 account = fields[0].GetUInt32();
@@ -516,21 +550,6 @@ std::list<uint32> RandomPlayerbotMgr::GetBots()
 
 vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
 {
-    set<uint32> bots;
-
-    QueryResult results = CharacterDatabase.PQuery(
-            "select `bot` from ai_playerbot_random_bots where event = 'add'");
-
-    if (results)
-    {
-        do
-        {
-            Field* fields = results->Fetch();
-            uint32 bot = uint64(fields[0].GetUInt64());
-            bots.insert(bot);
-        } while (results->NextRow());
-    }
-
     vector<uint32> guids;
     for (list<uint32>::iterator i = sPlayerbotAIConfig.randomBotAccounts.begin(); i != sPlayerbotAIConfig.randomBotAccounts.end(); i++)
     {
@@ -538,7 +557,9 @@ vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
         if (!sAccountMgr->GetCharactersCount(accountId))
             continue;
 
-        QueryResult result = CharacterDatabase.PQuery("SELECT guid, race FROM characters WHERE account = '%u'", accountId);
+        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARS_BY_ACCOUNT_ID);
+        stmt->setUInt32(0, accountId);
+        PreparedQueryResult result = CharacterDatabase.Query(stmt);
         if (!result)
             continue;
 
@@ -546,53 +567,150 @@ vector<uint32> RandomPlayerbotMgr::GetFreeBots(bool alliance)
         {
             Field* fields = result->Fetch();
             uint32 guid = fields[0].GetUInt32();
-            uint8 race = fields[1].GetUInt8();
-            if (bots.find(guid) == bots.end() &&
-                    (alliance == IsAlliance(race))
-               )
+
+            {
+                std::lock_guard<std::mutex> lock(eventValuesLock);
+                LoadEventValues();
+
+                auto events = eventValues.find(guid);
+                if (events != eventValues.end() && events->second.find("add") != events->second.end())
+                    continue;
+            }
+
+            CharacterCacheEntry const* data = sCharacterCache->GetCharacterCacheByGuid(guid);
+            if (data && alliance == IsAlliance(data->race))
                 guids.push_back(guid);
         } while (result->NextRow());
     }
 
-
     return guids;
 }
 
-uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string event)
+void RandomPlayerbotMgr::LoadEventValues()
 {
-    uint64 value = 0;
+    if (eventValuesLoaded)
+        return;
+
+    eventValuesLoaded = true;
 
-    QueryResult results = CharacterDatabase.PQuery(
-            "select `value`, `time`, validIn from ai_playerbot_random_bots where owner = 0 and bot = '%u' and event = '%s'",
-            bot, event.c_str());
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_PLAYERBOT_RANDOM_BOTS_EVENTS);
+    PreparedQueryResult results = CharacterDatabase.Query(stmt);
+    if (!results)
+        return;
 
-    if (results)
+    uint32 count = 0;
+    do
     {
         Field* fields = results->Fetch();
-        value = fields[0].GetUInt64();
-        uint64 lastChangeTime = fields[1].GetUInt64();
-        uint64 validIn = fields[2].GetUInt64();
-        if ((time(0) - lastChangeTime) >= validIn)
-            value = 0;
+        EventValue& eventValue = eventValues[uint32(fields[0].GetUInt64())][fields[1].GetString()];
+        eventValue.value = uint32(fields[2].GetUInt64());
+        eventValue.lastChangeTime = fields[3].GetUInt64();
+        eventValue.validIn = uint32(fields[4].GetUInt64());
+        ++count;
+    } while (results->NextRow());
+
+    sLog->outMessage("playerbot", LOG_LEVEL_INFO, "Loaded %u random bots event values", count);
+}
+
+void RandomPlayerbotMgr::SaveEventValue(uint32 bot, std::string const& event, EventValue const* eventValue)
+{
+    if (!pendingEventValues)
+        pendingEventValues = CharacterDatabase.BeginTransaction();
+
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYERBOT_RANDOM_BOTS_EVENT);
+    stmt->setUInt64(0, bot);
+    stmt->setString(1, event);
+    pendingEventValues->Append(stmt);
+
+    if (!eventValue)
+        return;
+
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_PLAYERBOT_RANDOM_BOTS_EVENT);
+    stmt->setUInt64(0, bot);
+    stmt->setUInt64(1, eventValue->lastChangeTime);
+    stmt->setUInt64(2, eventValue->validIn);
+    stmt->setString(3, event);
+    stmt->setUInt64(4, eventValue->value);
+    pendingEventValues->Append(stmt);
+}
+
+void RandomPlayerbotMgr::FlushEventValues()
+{
+    SQLTransaction trans;
+    {
+        std::lock_guard<std::mutex> lock(eventValuesLock);
+        std::swap(trans, pendingEventValues);
     }
 
-    return value;
+    if (trans)
+        CharacterDatabase.CommitTransaction(trans);
 }
 
-uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, std::string event, uint32 value, uint32 validIn)
+uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string const& event)
 {
-    CharacterDatabase.PExecute("delete from ai_playerbot_random_bots where owner = 0 and bot = '%u' and event = '%s'",
-            bot, event.c_str());
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+    LoadEventValues();
+
+    auto events = eventValues.find(bot);
+    if (events == eventValues.end())
+        return 0;
+
+    auto itr = events->second.find(event);
+    if (itr == events->second.end())
+        return 0;
+
+    EventValue const& eventValue = itr->second;
+    if ((time(0) - eventValue.lastChangeTime) >= eventValue.validIn)
+        return 0;
+
+    return eventValue.value;
+}
+
+uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, std::string const& event, uint32 value, uint32 validIn)
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+    LoadEventValues();
+
     if (value)
     {
-        CharacterDatabase.PExecute(
-                "insert into ai_playerbot_random_bots (owner, bot, `time`, validIn, event, `value`) values ('%u', '%u', '%u', '%u', '%s', '%u')",
-                0, bot, (uint32)time(0), validIn, event.c_str(), value);
+        EventValue& eventValue = eventValues[bot][event];
+        eventValue.value = value;
+        eventValue.lastChangeTime = time(0);
+        eventValue.validIn = validIn;
+        SaveEventValue(bot, event, &eventValue);
+    }
+    else
+    {
+        auto events = eventValues.find(bot);
+        if (events != eventValues.end())
+        {
+            events->second.erase(event);
+            if (events->second.empty())
+                eventValues.erase(events);
+        }
+        SaveEventValue(bot, event, nullptr);
     }
 
     return value;
 }
 
+void RandomPlayerbotMgr::SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn)
+{
+    std::lock_guard<std::mutex> lock(eventValuesLock);
+    LoadEventValues();
+
+    auto events = eventValues.find(bot);
+    if (events == eventValues.end())
+        return;
+
+    auto itr = events->second.find(event);
+    if (itr == events->second.end())
+        return;
+
+    itr->second.validIn = validIn;
+    SaveEventValue(bot, event, &itr->second);
+}
+
 bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, char const* args)
 {
     if (!sPlayerbotAIConfig.enabled)
@@ -611,7 +729,10 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
 
     if (cmd == "reset")
     {
-        CharacterDatabase.PExecute("delete from ai_playerbot_random_bots");
+        CharacterDatabase.Execute(CharacterDatabase.GetPreparedStatement(CHAR_DEL_PLAYERBOT_RANDOM_BOTS));
+        std::lock_guard<std::mutex> lock(sRandomPlayerbotMgr.eventValuesLock);
+        sRandomPlayerbotMgr.eventValues.clear();
+        sRandomPlayerbotMgr.pendingEventValues = nullptr;
         sLog->outMessage("playerbot", LOG_LEVEL_INFO, "Random bots were reset for all players. Please restart the Server.");
         return true;
     }
@@ -631,7 +752,9 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
         for (list<uint32>::iterator i = sPlayerbotAIConfig.randomBotAccounts.begin(); i != sPlayerbotAIConfig.randomBotAccounts.end(); ++i)
         {
             uint32 account = *i;
-            if (QueryResult results = CharacterDatabase.PQuery("SELECT guid FROM characters where account = '%u'", account))
+            PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARS_BY_ACCOUNT_ID);
+            stmt->setUInt32(0, account);
+            if (PreparedQueryResult results = CharacterDatabase.Query(stmt))
             {
                 do
                 {
@@ -658,10 +781,8 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
                         sRandomPlayerbotMgr.IncreaseLevel(bot);
                     }
                     uint32 randomTime = urand(sPlayerbotAIConfig.minRandomBotRandomizeTime, sPlayerbotAIConfig.maxRandomBotRandomizeTime);
-                    CharacterDatabase.PExecute("update ai_playerbot_random_bots set validIn = '%u' where event = 'randomize' and bot = '%u'",
-                            randomTime, bot->GetGUID().GetCounter());
-                    CharacterDatabase.PExecute("update ai_playerbot_random_bots set validIn = '%u' where event = 'logout' and bot = '%u'",
-                            sPlayerbotAIConfig.maxRandomBotInWorldTime, bot->GetGUID().GetCounter());
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUID().GetCounter(), "randomize", randomTime);
+                    sRandomPlayerbotMgr.SetEventValidIn(bot->GetGUID().GetCounter(), "logout", sPlayerbotAIConfig.maxRandomBotInWorldTime);
                 } while (results->NextRow());
             }
         }
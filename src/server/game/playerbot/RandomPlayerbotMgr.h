@@ -2,8 +2,10 @@
 #define _RandomPlayerbotMgr_H
 
 #include "Common.h"
+#include "DatabaseEnvFwd.h"
 #include "PlayerbotAIBase.h"
 #include "PlayerbotMgr.h"
+#include <mutex>
 
 class WorldLocation;
 class WorldPacket;
@@ -25,6 +27,7 @@ class TC_GAME_API RandomPlayerbotMgr : public PlayerbotHolder
             return instance;
         }
 
+        void UpdateAI(uint32 elapsed) override;
         void UpdateAIInternal(uint32 elapsed) override;
 
     public:
@@ -53,8 +56,33 @@ class TC_GAME_API RandomPlayerbotMgr : public PlayerbotHolder
         void OnBotLoginInternal(Player * const bot) override {}
 
     private:
-        uint32 GetEventValue(uint32 bot, std::string event);
-        uint32 SetEventValue(uint32 bot, std::string event, uint32 value, uint32 validIn);
+        struct EventValue
+        {
+            uint32 value;
+            uint64 lastChangeTime;
+            uint32 validIn;
+        };
+
+        struct CreatureSpawnPosition
+        {
+            float x, y, z;
+            uint8 minLevel, maxLevel;
+
+            float GetLevel() const { return (minLevel + maxLevel) / 2.0f; }
+        };
+        typedef std::vector<CreatureSpawnPosition> CreatureSpawnPositions;
+
+        uint32 GetEventValue(uint32 bot, std::string const& event);
+        uint32 SetEventValue(uint32 bot, std::string const& event, uint32 value, uint32 validIn);
+        void SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn);
+        // Event values are read once from ai_playerbot_random_bots, then kept in memory and written back by FlushEventValues
+        // Both must be called with eventValuesLock held
+        void LoadEventValues();
+        void SaveEventValue(uint32 bot, std::string const& event, EventValue const* eventValue);
+        void FlushEventValues();
+        // Creature spawns from ObjectMgr, by map and sorted by x, used instead of querying the creature table for teleport locations
+        void LoadCreatureSpawnPositions();
+        void GetCreatureSpawnPositions(uint32 mapId, float x, float y, float range, std::vector<CreatureSpawnPosition const*>& positions);
         list<uint32> GetBots();
         vector<uint32> GetFreeBots(bool alliance);
         bool ProcessBot(uint32 bot);
@@ -67,6 +95,15 @@ class TC_GAME_API RandomPlayerbotMgr : public PlayerbotHolder
     private:
         vector<Player*> players;
         int processTicks;
+
+        // event values are also read and set by bots actions from map threads (loot amount, buy and sell multipliers...)
+        std::mutex eventValuesLock;
+        bool eventValuesLoaded;
+        std::unordered_map<uint32 /*bot*/, std::unordered_map<std::string /*event*/, EventValue>> eventValues;
+        SQLTransaction pendingEventValues;
+
+        bool creatureSpawnPositionsLoaded;
+        std::unordered_map<uint32 /*mapId*/, CreatureSpawnPositions> creatureSpawnPositions;
 };
 
 //extra ifdef to make sure we don't try to include the playerbot mgr if playerbot are disabled
@@ -15,11 +15,11 @@ namespace ai
         virtual ~AiObjectContext() = default;
 
     public:
-        virtual std::shared_ptr<Strategy> GetStrategy(std::string name) { return strategyContexts.GetObject(name, ai); }
+        virtual std::shared_ptr<Strategy> GetStrategy(std::string const& name) { return strategyContexts.GetObject(name, ai); }
         virtual set<std::string> GetSiblingStrategy(std::string name) { return strategyContexts.GetSiblings(name); }
-        virtual std::shared_ptr<Trigger> GetTrigger(std::string name) { return triggerContexts.GetObject(name, ai); }
-        virtual std::shared_ptr<Action> GetAction(std::string name) { return actionContexts.GetObject(name, ai); }
-        virtual std::shared_ptr<UntypedValue> GetUntypedValue(std::string name) { return valueContexts.GetObject(name, ai); }
+        virtual std::shared_ptr<Trigger> GetTrigger(std::string const& name) { return triggerContexts.GetObject(name, ai); }
+        virtual std::shared_ptr<Action> GetAction(std::string const& name) { return actionContexts.GetObject(name, ai); }
+        virtual std::shared_ptr<UntypedValue> GetUntypedValue(std::string const& name) { return valueContexts.GetObject(name, ai); }
 
         template<class T>
         std::shared_ptr<Value<T>> GetValue(std::string name)
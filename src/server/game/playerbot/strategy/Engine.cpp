@@ -69,6 +69,7 @@ void Engine::Reset()
     queue.Clear();
     triggers.clear();
     multipliers.clear();
+    actionNodes.clear();
 }
 
 void Engine::Init()
@@ -93,7 +94,13 @@ void Engine::Init()
 }
 
 
-bool Engine::DoNextAction(Unit* unit, int depth)
+void Engine::PrepareNextAction()
+{
+    aiObjectContext->Update();
+    ProcessTriggers();
+}
+
+bool Engine::DoNextAction(Unit* unit, int depth, bool triggersProcessed)
 {
     LogAction("--- AI Tick ---");
     if (sPlayerbotAIConfig.logValuesPerTick)
@@ -103,8 +110,8 @@ bool Engine::DoNextAction(Unit* unit, int depth)
     std::shared_ptr<ActionBasket> basket = NULL;
 
     time_t currentTime = time(0);
-    aiObjectContext->Update();
-    ProcessTriggers();
+    if (!triggersProcessed)
+        PrepareNextAction();
 
     int iterations = 0;
     int iterationsPerTick = queue.Size() * sPlayerbotAIConfig.iterationsPerTick;
@@ -195,19 +202,25 @@ bool Engine::DoNextAction(Unit* unit, int depth)
     return actionExecuted;
 }
 
-std::shared_ptr<ActionNode> Engine::CreateActionNode(std::string name)
+std::shared_ptr<ActionNode> Engine::CreateActionNode(std::string const& name)
 {
-    for (auto i = strategies.begin(); i != strategies.end(); i++)
-    {
-        std::shared_ptr<Strategy> strategy = i->second;
-        std::shared_ptr<ActionNode> node = strategy->GetAction(name);
-        if (node)
-            return node;
-    }
-    return std::make_shared<ActionNode> (name,
-        /*P*/ ActionList(),
-        /*A*/ ActionList(),
-        /*C*/ ActionList());
+    // Nodes only depend on the current strategies, which reset the cache when they change
+    auto itr = actionNodes.find(name);
+    if (itr != actionNodes.end())
+        return itr->second;
+
+    std::shared_ptr<ActionNode> node;
+    for (auto i = strategies.begin(); i != strategies.end() && !node; i++)
+        node = i->second->GetAction(name);
+
+    if (!node)
+        node = std::make_shared<ActionNode> (name,
+            /*P*/ ActionList(),
+            /*A*/ ActionList(),
+            /*C*/ ActionList());
+
+    actionNodes.emplace(name, node);
+    return node;
 }
 
 bool Engine::MultiplyAndPush(ActionList actions, float forceRelevance, bool skipPrerequisites, Event event)
@@ -315,8 +328,18 @@ bool Engine::HasStrategy(std::string name)
     return strategies.find(name) != strategies.end();
 }
 
-void Engine::ProcessTriggers()
+void Engine::ProcessExternalTriggers(std::vector<std::shared_ptr<Trigger>> const& externalTriggers)
+{
+    ProcessTriggers(&externalTriggers);
+}
+
+void Engine::ProcessTriggers(std::vector<std::shared_ptr<Trigger>> const* onlyTriggers)
 {
+    auto isChecked = [onlyTriggers](std::shared_ptr<Trigger> const& trigger)
+    {
+        return !onlyTriggers || std::find(onlyTriggers->begin(), onlyTriggers->end(), trigger) != onlyTriggers->end();
+    };
+
     for (list<std::shared_ptr<TriggerNode>>::iterator i = triggers.begin(); i != triggers.end(); i++)
     {
         std::shared_ptr<TriggerNode> node = *i;
@@ -330,7 +353,7 @@ void Engine::ProcessTriggers()
             node->setTrigger(trigger);
         }
 
-        if (!trigger)
+        if (!trigger || !isChecked(trigger))
             continue;
 
         if (testMode || trigger->needCheck())
@@ -346,7 +369,7 @@ void Engine::ProcessTriggers()
     for (list<std::shared_ptr<TriggerNode>>::iterator i = triggers.begin(); i != triggers.end(); i++)
     {
         std::shared_ptr<Trigger> trigger = (*i)->getTrigger();
-        if (trigger) 
+        if (trigger && isChecked(trigger))
             trigger->Reset();
     }
 }
@@ -77,7 +77,11 @@ namespace ai
         string GetLastAction() { return lastAction; }
 
     public:
-        virtual bool DoNextAction(Unit*, int depth = 0);
+        // Update values and queue actions from triggers, done at the start of DoNextAction unless triggersProcessed
+        void PrepareNextAction();
+        virtual bool DoNextAction(Unit*, int depth = 0, bool triggersProcessed = false);
+        // Check given triggers again, for external events they received after PrepareNextAction
+        void ProcessExternalTriggers(std::vector<std::shared_ptr<Trigger>> const& externalTriggers);
         ActionResult ExecuteAction(std::string name);
 
     public:
@@ -96,10 +100,11 @@ namespace ai
     private:
         bool MultiplyAndPush(ActionList actions, float forceRelevance, bool skipPrerequisites, Event event);
         void Reset();
-        void ProcessTriggers();
+        // only check given triggers if any
+        void ProcessTriggers(std::vector<std::shared_ptr<Trigger>> const* onlyTriggers = nullptr);
         void PushDefaultActions();
         void PushAgain(std::shared_ptr<ActionNode> actionNode, float relevance, Event event);
-        std::shared_ptr<ActionNode> CreateActionNode(std::string name);
+        std::shared_ptr<ActionNode> CreateActionNode(std::string const& name);
         Action* InitializeAction(ActionNode* actionNode);
         bool ListenAndExecute(Action* action, Event event);
 
@@ -113,6 +118,7 @@ namespace ai
         std::list<std::shared_ptr<Multiplier>> multipliers;
         AiObjectContext* aiObjectContext;
         std::map<string, std::shared_ptr<Strategy>> strategies;
+        std::unordered_map<string, std::shared_ptr<ActionNode>> actionNodes;
         float lastRelevance;
         std::string lastAction;
 
@@ -34,28 +34,29 @@ namespace ai
         return true;
     }
 
-    void ExternalEventHelper::HandlePacket(std::map<uint16, std::string> &handlers, const WorldPacket &packet, Player* owner)
+    void ExternalEventHelper::HandlePacket(std::map<uint16, std::string> &handlers, WorldPacket &packet, Player* owner)
     {
         uint16 opcode = packet.GetOpcode();
         std::string name = handlers[opcode];
         if (name.empty())
             return;
 
-        static std::shared_ptr<Trigger> trigger = aiObjectContext->GetTrigger(name);
+        std::shared_ptr<Trigger> trigger = aiObjectContext->GetTrigger(name);
         if (!trigger)
             return;
 
-        WorldPacket p(packet);
-        trigger->ExternalEvent(p, owner);
+        trigger->ExternalEvent(packet, owner);
+        triggered.push_back(trigger);
     }
 
     bool ExternalEventHelper::HandleCommand(std::string name, std::string param, Player* owner)
     {
-        static std::shared_ptr<Trigger> trigger = aiObjectContext->GetTrigger(name);
+        std::shared_ptr<Trigger> trigger = aiObjectContext->GetTrigger(name);
         if (!trigger)
             return false;
 
         trigger->ExternalEvent(param, owner);
+        triggered.push_back(trigger);
         return true;
     }
 }
\ No newline at end of file
@@ -10,11 +10,15 @@ namespace ai
 
         bool ParseChatCommand(std::string command, Player* owner = nullptr);
 
-        void HandlePacket(std::map<uint16, std::string> &handlers, const WorldPacket &packet, Player* owner = nullptr);
+        void HandlePacket(std::map<uint16, std::string> &handlers, WorldPacket &packet, Player* owner = nullptr);
 
         bool HandleCommand(std::string name, std::string param, Player* owner = nullptr);
 
+        // Triggers which received an event through this helper
+        std::vector<std::shared_ptr<Trigger>> const& GetTriggered() const { return triggered; }
+
     private:
         AiObjectContext* aiObjectContext;
+        std::vector<std::shared_ptr<Trigger>> triggered;
     };
 }
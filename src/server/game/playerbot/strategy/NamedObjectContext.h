@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 
 namespace ai
 {
@@ -22,23 +23,26 @@ namespace ai
     {
     protected:
         typedef std::shared_ptr<T> (*ActionCreator) (PlayerbotAI* ai);
-        map<string, ActionCreator> creators;
+        std::unordered_map<string, ActionCreator> creators;
 
     public:
-        std::shared_ptr<T> create(std::string name, PlayerbotAI* ai)
+        std::shared_ptr<T> create(std::string const& name, PlayerbotAI* ai)
         {
             size_t found = name.find("::");
             std::string qualifier;
+            auto itr = creators.end();
             if (found != std::string::npos)
             {
                 qualifier = name.substr(found + 2);
-                name = name.substr(0, found);
+                itr = creators.find(name.substr(0, found));
             }
+            else
+                itr = creators.find(name);
 
-            if (creators.find(name) == creators.end())
+            if (itr == creators.end())
                 return nullptr;
 
-            ActionCreator creator = creators[name];
+            ActionCreator creator = itr->second;
             if (!creator)
                 return nullptr;
 
@@ -66,12 +70,13 @@ namespace ai
         NamedObjectContext(bool shared = false, bool supportsSiblings = false) :
             NamedObjectFactory<T>(), shared(shared), supportsSiblings(supportsSiblings) {}
 
-        std::shared_ptr<T> create(std::string name, PlayerbotAI* ai)
+        std::shared_ptr<T> create(std::string const& name, PlayerbotAI* ai)
         {
-            if (created.find(name) == created.end())
-                return created[name] = NamedObjectFactory<T>::create(name, ai);
+            auto itr = created.find(name);
+            if (itr == created.end())
+                itr = created.emplace(name, NamedObjectFactory<T>::create(name, ai)).first;
 
-            return created[name];
+            return itr->second;
         }
 
         virtual ~NamedObjectContext()
@@ -86,7 +91,7 @@ namespace ai
 
         void Update()
         {
-            for (typename map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
+            for (auto i = created.begin(); i != created.end(); i++)
             {
                 if (i->second)
                     i->second->Update();
@@ -95,7 +100,7 @@ namespace ai
 
         void Reset()
         {
-            for (typename map<string, std::shared_ptr<T>>::iterator i = created.begin(); i != created.end(); i++)
+            for (auto i = created.begin(); i != created.end(); i++)
             {
                 if (i->second)
                     i->second->Reset();
@@ -114,7 +119,7 @@ namespace ai
         }
 
     protected:
-        map<string, std::shared_ptr<T>> created;
+        std::unordered_map<string, std::shared_ptr<T>> created; // also holds nullptr for names this context doesn't support
         bool shared;
         bool supportsSiblings;
     };
@@ -135,16 +140,23 @@ namespace ai
         void Add(NamedObjectContext<T>* context)
         {
             contexts.push_back(context);
+            resolved.clear();
         }
 
-        std::shared_ptr<T> GetObject(std::string name, PlayerbotAI* ai)
+        // Objects are never removed from contexts, so a name resolves to the same object for the whole life of the list.
+        // Resolve it once, then it's a single lookup instead of a lookup in every context.
+        std::shared_ptr<T> GetObject(std::string const& name, PlayerbotAI* ai)
         {
-            for (auto i = contexts.begin(); i != contexts.end(); i++)
-            {
-                std::shared_ptr<T> object = (*i)->create(name, ai);
-                if (object) return object;
-            }
-            return nullptr;
+            auto itr = resolved.find(name);
+            if (itr != resolved.end())
+                return itr->second;
+
+            std::shared_ptr<T> object;
+            for (auto i = contexts.begin(); i != contexts.end() && !object; i++)
+                object = (*i)->create(name, ai);
+
+            resolved.emplace(name, object);
+            return object;
         }
 
         void Update()
@@ -213,6 +225,7 @@ namespace ai
 
     private:
         list<NamedObjectContext<T>*> contexts;
+        std::unordered_map<std::string, std::shared_ptr<T>> resolved;
     };
 
     template <class T> class NamedObjectFactoryList
@@ -1,5 +1,6 @@
 #include "Chat.h"
 #include "Profiler.h"
+#include "Tracing.h"
 
 class profiling_commandscript : public CommandScript
 {
@@ -8,11 +9,19 @@ public:
 
     std::vector<ChatCommand> GetCommands() const override
     {
+        static std::vector<ChatCommand> traceCommandTable =
+        {
+            { "enable",    SEC_SUPERADMIN,   true,  &HandleTraceEnableCommand,                "" },
+            { "disable",   SEC_SUPERADMIN,   true,  &HandleTraceDisableCommand,               "" },
+            { "dump",      SEC_SUPERADMIN,   true,  &HandleTraceDumpCommand,                  "" },
+            { "status",    SEC_SUPERADMIN,   true,  &HandleTraceStatusCommand,                "" },
+        };
         static std::vector<ChatCommand> profilingCommandTable =
         {
             { "start",     SEC_SUPERADMIN,   true,  &HandleProfilingStartCommand,             "" },
             { "stop",      SEC_SUPERADMIN,   true,  &HandleProfilingStopCommand,              "" },
             { "status",    SEC_SUPERADMIN,   true,  &HandleProfilingStatusCommand,            "" },
+            { "trace",     SEC_SUPERADMIN,   true,  nullptr,                                  "", traceCommandTable },
         };
         static std::vector<ChatCommand> commandTable =
         {
@@ -57,6 +66,47 @@ public:
         handler->PSendSysMessage("Profiling infos:\n%s", infos.c_str());
         return true;
     }
+
+    /* .profiling trace enable */
+    static bool HandleTraceEnableCommand(ChatHandler* handler, char const* args)
+    {
+        sTracing->SetEnabled(true);
+        handler->SendSysMessage("Tracing enabled");
+        return true;
+    }
+
+    /* .profiling trace disable */
+    static bool HandleTraceDisableCommand(ChatHandler* handler, char const* args)
+    {
+        sTracing->SetEnabled(false);
+        handler->SendSysMessage("Tracing disabled");
+        return true;
+    }
+
+    /* .profiling trace dump [filename] */
+    static bool HandleTraceDumpCommand(ChatHandler* handler, char const* args)
+    {
+        //default filename
+        std::string filename = std::to_string(time(nullptr)) + ".trace.json";
+        char* cFileName = strtok((char*)args, " ");
+        if (cFileName)
+            filename = cFileName;
+
+        std::string failureReason;
+        if (sTracing->Dump(filename, failureReason))
+            handler->PSendSysMessage("Trace dumped to %s", filename.c_str());
+        else
+            handler->PSendSysMessage("Trace dump failed with reason %s", failureReason.c_str());
+        return true;
+    }
+
+    /* .profiling trace status */
+    static bool HandleTraceStatusCommand(ChatHandler* handler, char const* args)
+    {
+        std::string infos = sTracing->GetInfos();
+        handler->PSendSysMessage("Tracing infos:\n%s", infos.c_str());
+        return true;
+    }
 };
 
 void AddSC_profiling_commandscript()
@@ -17,6 +17,7 @@
 
 #include "DBCStore.h"
 #include "DBCDatabaseLoader.h"
+#include "MappedFile.h"
 
 DBCStorageBase::DBCStorageBase(char const* fmt) : _fieldCount(0), _fileFormat(fmt), _dataTable(nullptr), _indexTableSize(0)
 {
@@ -44,8 +45,8 @@ bool DBCStorageBase::Load(char const* path, char**& indexTable)
     _dataTable = dbc.AutoProduceData(_fileFormat, _indexTableSize, indexTable);
 
     // load strings from dbc data
-    if (char* stringBlock = dbc.AutoProduceStrings(_fileFormat, _dataTable))
-        _stringPool.push_back(stringBlock);
+    if (dbc.AutoProduceStrings(_fileFormat, _dataTable))
+        _stringFiles.push_back(dbc.GetFile());
 
     // error in dbc file at loading if NULL
     return indexTable != nullptr;
@@ -63,8 +64,8 @@ bool DBCStorageBase::LoadStringsFrom(char const* path, char** indexTable)
         return false;
 
     // load strings from another locale dbc data
-    if (char* stringBlock = dbc.AutoProduceStrings(_fileFormat, _dataTable))
-        _stringPool.push_back(stringBlock);
+    if (dbc.AutoProduceStrings(_fileFormat, _dataTable))
+        _stringFiles.push_back(dbc.GetFile());
 
     return true;
 }
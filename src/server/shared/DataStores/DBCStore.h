@@ -3,8 +3,11 @@
 
 #include "Common.h"
 #include "DBCStorageIterator.h"
+#include <memory>
 #include <vector>
 
+class MappedFile;
+
 /// Interface class for common access
 class TC_SHARED_API DBCStorageBase
 {
@@ -28,6 +31,7 @@ protected:
     char const* _fileFormat;
     char* _dataTable;
     std::vector<char*> _stringPool;
+    std::vector<std::shared_ptr<MappedFile>> _stringFiles; // dbc files strings point to
     uint32 _indexTableSize;
 };
 
@@ -42,6 +42,9 @@ public:
 
     MessageBuffer(MessageBuffer&& right) : _wpos(right._wpos), _rpos(right._rpos), _storage(right.Move()) { }
 
+    // Take over given storage (content is discarded, only the allocated memory is reused)
+    explicit MessageBuffer(std::vector<uint8>&& storage) : _wpos(0), _rpos(0), _storage(std::move(storage)) { }
+
     void Reset()
     {
         _wpos = 0;
@@ -20,8 +20,9 @@
 
 #include "MessageBuffer.h"
 #include "Log.h"
+#include <algorithm>
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <type_traits>
@@ -30,6 +31,8 @@
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+// max number of queued buffers sent by a single vectored write, stays well below IOV_MAX
+#define MAX_GATHERED_WRITE_BUFFERS 64
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
@@ -92,7 +95,17 @@ public:
 
     void QueuePacket(MessageBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.emplace_back(std::move(buffer));
+
+#ifdef TC_SOCKET_USE_IOCP
+        AsyncProcessQueue();
+#endif
+    }
+
+    /// Queue data without copying it, owner is kept alive until the data has been sent
+    void QueueSharedBuffer(std::shared_ptr<void const> owner, uint8 const* data, std::size_t size)
+    {
+        _writeQueue.emplace_back(std::move(owner), data, size);
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -133,8 +146,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        GatherWriteBuffers();
+        _socket.async_write_some(_writeBuffers, std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -154,6 +167,61 @@ protected:
     }
 
 private:
+    /* Queued data, either a buffer owned by the socket (headers and coalesced packets)
+    or data owned by someone else and kept alive by Owner until it has been sent (shared packets) */
+    class WriteSegment
+    {
+    public:
+        explicit WriteSegment(MessageBuffer&& buffer) : _buffer(std::move(buffer)), _data(nullptr), _size(0) { }
+        WriteSegment(std::shared_ptr<void const>&& owner, uint8 const* data, std::size_t size) : _buffer(0), _owner(std::move(owner)), _data(data), _size(size) { }
+
+        uint8 const* GetReadPointer() { return _owner ? _data : _buffer.GetReadPointer(); }
+        std::size_t GetActiveSize() const { return _owner ? _size : _buffer.GetActiveSize(); }
+
+        void ReadCompleted(std::size_t bytes)
+        {
+            if (_owner)
+            {
+                _data += bytes;
+                _size -= bytes;
+            }
+            else
+                _buffer.ReadCompleted(bytes);
+        }
+
+    private:
+        MessageBuffer _buffer;
+        std::shared_ptr<void const> _owner;
+        uint8 const* _data;
+        std::size_t _size;
+    };
+
+    // Fill _writeBuffers with the first queued segments so that they're all sent by a single (vectored) write
+    void GatherWriteBuffers()
+    {
+        _writeBuffers.clear();
+        for (auto itr = _writeQueue.begin(); itr != _writeQueue.end() && _writeBuffers.size() < MAX_GATHERED_WRITE_BUFFERS; ++itr)
+            if (itr->GetActiveSize())
+                _writeBuffers.emplace_back(itr->GetReadPointer(), itr->GetActiveSize());
+    }
+
+    // Remove sent bytes from the queue, popping fully sent segments
+    void WriteCompleted(std::size_t bytes)
+    {
+        while (!_writeQueue.empty())
+        {
+            WriteSegment& segment = _writeQueue.front();
+            std::size_t const segmentBytes = std::min(bytes, segment.GetActiveSize());
+            segment.ReadCompleted(segmentBytes);
+            bytes -= segmentBytes;
+
+            if (segment.GetActiveSize())
+                break;
+
+            _writeQueue.pop_front();
+        }
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -173,9 +241,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -199,37 +265,34 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        GatherWriteBuffers();
+        std::size_t const bytesToSend = boost::asio::buffer_size(_writeBuffers);
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(_writeBuffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+
+        WriteCompleted(bytesSent);
+        if (bytesSent < bytesToSend) // now n > 0
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -243,7 +306,8 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<WriteSegment> _writeQueue;
+    std::vector<boost::asio::const_buffer> _writeBuffers;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
@@ -435,6 +435,13 @@ public:
     size_t size() const { return _storage.size(); }
     bool empty() const { return _storage.empty(); }
 
+    std::vector<uint8>&& Move()
+    {
+        _rpos = 0;
+        _wpos = 0;
+        return std::move(_storage);
+    }
+
     void resize(size_t newsize)
     {
         _storage.resize(newsize, 0);
@@ -41,6 +41,7 @@
 #include "ScriptReloadMgr.h"
 #include "AppenderDB.h"
 #include "MySQLThreading.h"
+#include "Tracing.h"
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_UNIX
 #include <fstream>
 #include <execinfo.h>
@@ -183,8 +184,7 @@ extern int main(int argc, char **argv)
     std::shared_ptr<Trinity::Asio::IoContext> ioContext = std::make_shared<Trinity::Asio::IoContext>();
 
     sLog->RegisterAppender<AppenderDB>();
-    // If logs are supposed to be handled async then we need to pass the ioContext into the Log singleton
-    sLog->Initialize(sConfigMgr->GetBoolDefault("Log.Async.Enable", false) ? ioContext.get() : nullptr);
+    sLog->Initialize(sConfigMgr->GetBoolDefault("Log.Async.Enable", false));
 
     Trinity::Banner::Show("worldserver-daemon",
         [](char const* text)
@@ -577,6 +577,8 @@ void FreezeDetector::Handler(std::weak_ptr<FreezeDetector> freezeDetectorRef, bo
 
 void WorldUpdateLoop()
 {
+    sTracing->SetThreadName("World");
+
     uint32 realCurrTime = 0;
     uint32 realPrevTime = GetMSTime();
 